@@ -0,0 +1,1171 @@
+// bench.cpp : benchmarks for the set classes of lab 2
+// Usage: Lab2Bench <benchmark> [n]
+// Run Lab2Bench without arguments to list the benchmarks
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <cstdlib>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <numeric>
+#include <bit>
+#include <set>
+#include <array>
+#include <iterator>
+#include <compare>
+#if __has_include(<flat_set>)
+#include <flat_set>
+#endif
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#include "set.h"
+#include "flatset.h"
+#include "bitmapset.h"
+#include "parallelsort.h"
+#include "concurrentset.h"
+#include "persistentset.h"
+#include "setfile.h"
+#include "unrolledset.h"
+#include "settelemetry.h"
+#include "smallset.h"
+#include "packedset.h"
+#include "compactset.h"
+#include "bufferedset.h"
+
+/****************************************
+ * Helpers                               *
+ *****************************************/
+
+// Run f once and return the elapsed time in seconds
+double time_it(const std::function<void()>& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Number of bytes allocated on the heap, including allocator overhead and large blocks mapped by mmap (0 if unknown)
+size_t heap_in_use() {
+#if defined(__GLIBC__)
+    const auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+// Heap bytes used by the object returned by make
+template <typename T>
+size_t heap_bytes(const std::function<T()>& make) {
+    size_t before = heap_in_use();
+    T object = make();
+    return heap_in_use() - before;
+}
+
+/*
+ * Sorted vectors of distinct ints with n values
+ *   dense:     90% of the ints in [0, n / 0.9)
+ *   sparse:    ints spread over the whole int range
+ *   clustered: runs of 64 to 1024 consecutive ints separated by gaps
+ */
+std::vector<int> make_values(const std::string& distribution, size_t n, unsigned seed) {
+    std::mt19937 gen{seed};
+    std::vector<int> V;
+    V.reserve(n);
+
+    if (distribution == "dense") {
+        const int range = static_cast<int>(n / 0.9) + 1;
+        std::bernoulli_distribution keep{0.9};
+        for (int i = 0; i < range && V.size() < n; ++i) {
+            if (keep(gen)) V.push_back(i);
+        }
+    } else if (distribution == "sparse") {
+        std::uniform_int_distribution<int> dist{-2'000'000'000, 2'000'000'000};
+        while (V.size() < n) {
+            for (size_t i = V.size(); i < n; ++i) V.push_back(dist(gen));
+            std::sort(V.begin(), V.end());
+            V.erase(std::unique(V.begin(), V.end()), V.end());
+        }
+    } else {  // clustered
+        std::uniform_int_distribution<int> run{64, 1024};
+        std::uniform_int_distribution<int> gap{1, 20000};
+        int val = 0;
+        while (V.size() < n) {
+            val += gap(gen);
+            for (int k = run(gen); k > 0 && V.size() < n; --k) V.push_back(val++);
+        }
+    }
+    return V;
+}
+
+/****************************************
+ * Benchmarks                            *
+ *****************************************/
+
+// Memory per element and throughput of +=, *= and -= for Set, FlatSet and BitmapSet
+void bench_bitmap(size_t n) {
+    std::cout << "Set, FlatSet and BitmapSet with n = " << n << " (heap bytes per element, Melements/s)\n\n";
+    std::cout << std::left << std::setw(12) << "data" << std::setw(12) << "set" << std::right
+              << std::setw(10) << "bytes" << std::setw(10) << "+=" << std::setw(10) << "*="
+              << std::setw(10) << "-=" << "\n";
+
+    for (std::string distribution : {"dense", "sparse", "clustered"}) {
+        const std::vector<int> A = make_values(distribution, n, 1);
+        const std::vector<int> B = make_values(distribution, n, 2);
+
+        auto report = [&]<typename T>(const char* name, T a, T b) {
+            const double bytes = static_cast<double>(heap_bytes<T>([&] { return T{A}; })) / n;
+            std::cout << std::left << std::setw(12) << distribution << std::setw(12) << name << std::right
+                      << std::fixed << std::setprecision(2) << std::setw(10) << bytes;
+            for (int op = 0; op < 3; ++op) {
+                T result{a};
+                const double secs = time_it([&] {
+                    if (op == 0) result += b;
+                    if (op == 1) result *= b;
+                    if (op == 2) result -= b;
+                });
+                std::cout << std::setw(10) << (2.0 * n / secs / 1e6);
+            }
+            std::cout << "\n";
+        };
+
+        report("Set", Set{A}, Set{B});
+        report("FlatSet", FlatSet{A}, FlatSet{B});
+        report("BitmapSet", BitmapSet{A}, BitmapSet{B});
+    }
+}
+
+// Load time of n unsorted ints with about 37% repetitions, from memory and from a text file
+// The time to destroy the sets is not included
+void bench_load(size_t n) {
+    std::mt19937 gen{7};
+    std::uniform_int_distribution<int> dist{0, static_cast<int>(n)};
+    std::vector<int> V(n);
+    for (int& val : V) val = dist(gen);
+
+    std::cout << "Load n = " << n << " unsorted ints, " << default_thread_count() << " threads (seconds)\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    {
+        std::vector<int> W{V};
+        double sort_secs = time_it([&] {
+            std::sort(W.begin(), W.end());
+            W.erase(std::unique(W.begin(), W.end()), W.end());
+        });
+        Set S;
+        double build_secs = time_it([&] { S = Set{W}; });
+        std::cout << std::left << std::setw(40) << "std::sort + unique + Set(vector)" << std::right
+                  << std::setw(8) << sort_secs + build_secs << "  (sort " << sort_secs << ")\n";
+    }
+    {
+        std::vector<int> W{V};
+        double sort_secs = time_it([&] { parallel_sort_unique(W); });
+        Set S;
+        double total_secs = time_it([&] { S = Set::from_unsorted(V); });
+        std::cout << std::left << std::setw(40) << "Set::from_unsorted" << std::right << std::setw(8)
+                  << total_secs << "  (sort " << sort_secs << ")\n";
+    }
+    {
+        FlatSet F;
+        double secs = time_it([&] { F = FlatSet::from_unsorted(V); });
+        std::cout << std::left << std::setw(40) << "FlatSet::from_unsorted" << std::right << std::setw(8)
+                  << secs << "\n";
+    }
+    {
+        const auto file = std::filesystem::temp_directory_path() / "lab2_bench_load.txt";
+        {
+            std::ofstream os{file};
+            for (int val : V) os << val << '\n';
+        }
+        Set S;
+        double secs = time_it([&] { S = Set::from_file(file); });
+        std::cout << std::left << std::setw(40) << "Set::from_file" << std::right << std::setw(8) << secs
+                  << "  (" << std::filesystem::file_size(file) / 1e6 << " MB)\n";
+
+        Set S2;
+        secs = time_it([&] {
+            std::ifstream is{file};
+            S2 = Set::from_unsorted(std::istream_iterator<int>{is}, std::istream_iterator<int>{});
+        });
+        std::cout << std::left << std::setw(40) << "Set::from_unsorted(istream_iterator)" << std::right
+                  << std::setw(8) << secs << "\n";
+        std::filesystem::remove(file);
+    }
+}
+
+// Union and intersection of k = 200 Sets with n values each: pairwise operators against union_all and intersect_all
+void bench_kway(const std::string& distribution, size_t n) {
+    constexpr int k = 200;
+    std::vector<Set> sets;
+    for (int i = 0; i < k; ++i) {
+        sets.push_back(Set{make_values(distribution, n, i + 1)});
+    }
+    std::cout << "k = " << k << " " << distribution << " Sets with n = " << n << " values, "
+              << default_thread_count() << " threads (seconds)\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    auto report = [](const char* name, double secs) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(8) << secs << "\n";
+    };
+
+    Set U;
+    report("operator+= applied pairwise", time_it([&] {
+               for (const Set& S : sets) U += S;
+           }));
+    Set U1;
+    report("Set::union_all, 1 thread", time_it([&] { U1 = Set::union_all(sets); }));
+    Set U2;
+    report("Set::union_all, all threads", time_it([&] { U2 = Set::union_all(sets, 0); }));
+
+    Set I{sets[0]};
+    report("operator*= applied pairwise", time_it([&] {
+               for (const Set& S : sets) I *= S;
+           }));
+    Set I1;
+    report("Set::intersect_all, 1 thread", time_it([&] { I1 = Set::intersect_all(sets); }));
+    Set I2;
+    report("Set::intersect_all, all threads", time_it([&] { I2 = Set::intersect_all(sets, 0); }));
+
+    if (U1 != U || U2 != U || I1 != I || I2 != I) {
+        std::cerr << "Different results!\n";
+    }
+}
+
+// dense Sets overlap almost completely, sparse Sets hardly overlap
+void bench_kway(size_t n) {
+    for (std::string distribution : {"dense", "sparse"}) {
+        bench_kway(distribution, n);
+        std::cout << "\n";
+    }
+}
+
+// Throughput of a ConcurrentSet and of a Set guarded by one mutex, with n values in [0, 2n),
+// for 1, 2, 4, ... threads up to the number of hardware threads
+// Each thread runs ops_per_thread operations: lookups, and inserts and erases of random values
+void bench_concurrent(size_t n) {
+    constexpr int ops_per_thread = 20000;
+    const unsigned max_threads = default_thread_count();
+    std::vector<int> A;
+    for (int i = 0; i < static_cast<int>(2 * n); i += 2) A.push_back(i);
+
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    std::cout << "n = " << n << " values, " << max_threads << " hardware threads (Mops/s)\n\n";
+    std::cout << std::left << std::setw(12) << "writes" << std::setw(16) << "set" << std::right;
+    for (unsigned t : thread_counts) std::cout << std::setw(10) << (std::to_string(t) + " thr");
+    std::cout << "\n" << std::fixed << std::setprecision(3);
+
+    // One operation: lookup with probability 1 - writes, insert or erase otherwise
+    auto run = [&](unsigned n_threads, double writes, auto lookup, auto insert, auto erase) {
+        const double secs = time_it([&] {
+            std::vector<std::jthread> threads;
+            for (unsigned t = 0; t < n_threads; ++t) {
+                threads.emplace_back([&, t] {
+                    std::mt19937 gen{t + 1};
+                    std::uniform_int_distribution<int> value{0, static_cast<int>(2 * n) - 1};
+                    std::bernoulli_distribution is_write{writes};
+                    for (int op = 0; op < ops_per_thread; ++op) {
+                        const int val = value(gen);
+                        if (!is_write(gen)) {
+                            lookup(val);
+                        } else if (op % 2 == 0) {
+                            insert(val);
+                        } else {
+                            erase(val);
+                        }
+                    }
+                });
+            }
+        });
+        return static_cast<double>(n_threads) * ops_per_thread / secs / 1e6;
+    };
+
+    for (double writes : {0.0, 0.1, 0.5}) {
+        std::cout << std::left << std::setw(12) << (std::to_string(static_cast<int>(writes * 100)) + "%")
+                  << std::setw(16) << "ConcurrentSet" << std::right;
+        for (unsigned t : thread_counts) {
+            ConcurrentSet C{A};
+            std::cout << std::setw(10)
+                      << run(
+                             t, writes, [&](int val) { return C.is_member(val); },
+                             [&](int val) { return C.insert(val); }, [&](int val) { return C.erase(val); });
+        }
+        std::cout << "\n";
+
+        std::cout << std::left << std::setw(12) << "" << std::setw(16) << "Set + mutex" << std::right;
+        for (unsigned t : thread_counts) {
+            Set S{A};
+            std::mutex m;
+            std::cout << std::setw(10)
+                      << run(
+                             t, writes,
+                             [&](int val) {
+                                 std::scoped_lock lock{m};
+                                 return S.is_member(val);
+                             },
+                             [&](int val) {
+                                 std::scoped_lock lock{m};
+                                 S += val;
+                             },
+                             [&](int val) {
+                                 std::scoped_lock lock{m};
+                                 S -= val;
+                             });
+        }
+        std::cout << "\n";
+    }
+}
+
+// Snapshots of a Set and of a PersistentSet with n values, and operations on a snapshot modified in 100 places
+void bench_persistent(size_t n) {
+    const std::vector<int> A = make_values("dense", n, 1);
+    std::cout << "n = " << n << " values (seconds)\n\n";
+    std::cout << std::left << std::setw(32) << "" << std::right << std::setw(12) << "Set" << std::setw(16)
+              << "PersistentSet" << "\n";
+    std::cout << std::scientific << std::setprecision(2);
+
+    Set S{A};
+    PersistentSet P{A};
+    auto report = [](const char* name, double set_secs, double persistent_secs) {
+        std::cout << std::left << std::setw(32) << name << std::right << std::setw(12) << set_secs
+                  << std::setw(16) << persistent_secs << "\n";
+    };
+
+    Set S_copy;
+    PersistentSet P_copy;
+    report("snapshot (copy)", time_it([&] { S_copy = S; }), time_it([&] { P_copy = P; }));
+
+    std::mt19937 gen{3};
+    std::uniform_int_distribution<int> dist{0, static_cast<int>(n)};
+    std::vector<int> changes(100);
+    for (int& val : changes) val = dist(gen);
+
+    report("insert 100 values into snapshot", time_it([&] {
+               for (int val : changes) S_copy += val;
+           }),
+           time_it([&] {
+               for (int val : changes) P_copy.insert(val);
+           }));
+
+    Set S_result;
+    PersistentSet P_result;
+    report("union with snapshot", time_it([&] { S_result = S + S_copy; }),
+           time_it([&] { P_result = P + P_copy; }));
+    report("intersection with snapshot", time_it([&] { S_result = S * S_copy; }),
+           time_it([&] { P_result = P * P_copy; }));
+    report("difference with snapshot", time_it([&] { S_result = S_copy - S; }),
+           time_it([&] { P_result = P_copy - P; }));
+    report("comparison with snapshot", time_it([&] { [[maybe_unused]] volatile bool b = (S <= S_copy); }),
+           time_it([&] { [[maybe_unused]] volatile bool b = (P <= P_copy); }));
+
+    std::cout << "\nheap bytes per value" << std::fixed << std::setprecision(1) << std::setw(24)
+              << static_cast<double>(heap_bytes<Set>([&] { return Set{A}; })) / n << std::setw(16)
+              << static_cast<double>(heap_bytes<PersistentSet>([&] { return PersistentSet{A}; })) / n << "\n";
+}
+
+// Size of the intersection of two Sets with n values: materialized result against non-materializing queries
+void bench_queries(size_t n) {
+    const Set S1{make_values("dense", n, 1)};
+    const Set S2{make_values("dense", n, 2)};
+    std::cout << "n = " << n << " values (seconds)\n\n";
+    std::cout << std::fixed << std::setprecision(4);
+
+    auto report = [](const char* name, double secs) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(8) << secs << "\n";
+    };
+
+    volatile size_t size = 0;
+    report("Set{S1 * S2}.cardinality()", time_it([&] { size = Set{S1 * S2}.cardinality(); }));
+    report("(S1 * S2).cardinality()", time_it([&] { size = (S1 * S2).cardinality(); }));
+    report("S1.intersection_size(S2)", time_it([&] { size = S1.intersection_size(S2); }));
+    report("S1.union_size(S2)", time_it([&] { size = S1.union_size(S2); }));
+    volatile double similarity = 0.0;
+    report("S1.jaccard(S2)", time_it([&] { similarity = S1.jaccard(S2); }));
+    volatile bool disjoint = false;
+    report("S1.is_disjoint(S2)", time_it([&] { disjoint = S1.is_disjoint(S2); }));
+}
+
+// Streaming n increasing values into a Set: operator+= with a singleton against hinted insert
+void bench_stream(size_t n) {
+    std::vector<int> A(n);
+    for (size_t i = 0; i < n; ++i) A[i] = static_cast<int>(3 * i);
+    std::cout << "n = " << n << " increasing values (seconds)\n\n";
+    std::cout << std::fixed << std::setprecision(4);
+
+    auto report = [](const char* name, double secs) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(8) << secs << "\n";
+    };
+
+    Set S1, S2, S3;
+    report("S += val", time_it([&] {
+               for (int val : A) S1 += val;
+           }));
+    report("S.insert(val)", time_it([&] {
+               for (int val : A) S2.insert(val);
+           }));
+    report("std::copy to std::inserter(S, S.end())",
+           time_it([&] { std::copy(A.begin(), A.end(), std::inserter(S3, S3.end())); }));
+}
+
+// File size, write time and load time of a Set with n values, as text and as a binary file
+void bench_file(size_t n) {
+    const auto text_file = std::filesystem::temp_directory_path() / "lab2_bench_file.txt";
+    const auto binary_file = std::filesystem::temp_directory_path() / "lab2_bench_file.set";
+
+    std::cout << "n = " << n << " values (MB, seconds)\n\n";
+    std::cout << std::left << std::setw(12) << "data" << std::setw(10) << "format" << std::right
+              << std::setw(10) << "MB" << std::setw(10) << "write" << std::setw(10) << "load"
+              << std::setw(14) << "1e5 lookups" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (std::string distribution : {"dense", "sparse"}) {
+        const Set S{make_values(distribution, n, 1)};
+
+        // The text is written as operator<< does, without the braces, so that Set::from_file can read it
+        double write_secs = time_it([&] {
+            std::ofstream os{text_file};
+            for (int val : S) os << val << ' ';
+        });
+        Set S_text;
+        double load_secs = time_it([&] { S_text = Set::from_file(text_file); });
+        std::cout << std::left << std::setw(12) << distribution << std::setw(10) << "text" << std::right
+                  << std::setw(10) << std::filesystem::file_size(text_file) / 1e6 << std::setw(10) << write_secs
+                  << std::setw(10) << load_secs << std::setw(14) << "-" << "\n";
+
+        write_secs = time_it([&] { write_binary(S, binary_file); });
+        Set S_binary;
+        load_secs = time_it([&] { S_binary = read_binary(binary_file); });
+
+        std::mt19937 gen{5};
+        std::uniform_int_distribution<int> dist{S.to_vector().front(), S.to_vector().back()};
+        std::vector<int> queries(100000);
+        for (int& val : queries) val = dist(gen);
+        volatile size_t found = 0;
+        const double query_secs = time_it([&] {
+            const MappedSet M{binary_file};
+            for (int val : queries) found = found + M.is_member(val);
+        });
+        std::cout << std::left << std::setw(12) << "" << std::setw(10) << "binary" << std::right << std::setw(10)
+                  << std::filesystem::file_size(binary_file) / 1e6 << std::setw(10) << write_secs << std::setw(10)
+                  << load_secs << std::setw(14) << query_secs << "\n";
+
+        if (S_text != S || S_binary != S) {
+            std::cerr << "Different results!\n";
+        }
+    }
+    std::filesystem::remove(text_file);
+    std::filesystem::remove(binary_file);
+}
+
+// Memory per element and traversal speed of Set, UnrolledSet and CompactSet
+// scan compares two equal sets, i.e. it only walks both lists, and insert adds 1000 random values one by one
+void bench_unrolled(size_t n) {
+    std::cout << "Set, UnrolledSet and CompactSet with n = " << n << " (heap bytes per element, Melements/s)\n\n";
+    std::cout << std::left << std::setw(12) << "data" << std::setw(14) << "set" << std::right
+              << std::setw(10) << "bytes" << std::setw(10) << "scan" << std::setw(10) << "+="
+              << std::setw(10) << "*=" << std::setw(10) << "-=" << std::setw(14) << "us/insert" << "\n";
+
+    for (std::string distribution : {"dense", "sparse"}) {
+        const std::vector<int> A = make_values(distribution, n, 1);
+        const std::vector<int> B = make_values(distribution, n, 2);
+        std::mt19937 gen{3};
+        std::uniform_int_distribution<int> dist{A.front(), A.back()};
+        std::vector<int> inserts(1000);
+        for (int& val : inserts) val = dist(gen);
+
+        auto report = [&]<typename T>(const char* name, T a, T b) {
+            const double bytes = static_cast<double>(heap_bytes<T>([&] { return T{A}; })) / n;
+            std::cout << std::left << std::setw(12) << distribution << std::setw(14) << name << std::right
+                      << std::fixed << std::setprecision(2) << std::setw(10) << bytes;
+
+            const T copy{a};
+            volatile bool equal = false;
+            std::cout << std::setw(10) << (2.0 * n / time_it([&] { equal = (a == copy); }) / 1e6);
+            for (int op = 0; op < 3; ++op) {
+                T result{a};
+                const double secs = time_it([&] {
+                    if (op == 0) result += b;
+                    if (op == 1) result *= b;
+                    if (op == 2) result -= b;
+                });
+                std::cout << std::setw(10) << (2.0 * n / secs / 1e6);
+            }
+
+            T result{a};
+            const double secs = time_it([&] {
+                for (int val : inserts) result.insert(val);
+            });
+            std::cout << std::setw(14) << (secs / inserts.size() * 1e6) << "\n";
+        };
+
+        report("Set", Set{A}, Set{B});
+        report("UnrolledSet", UnrolledSet{A}, UnrolledSet{B});
+        report("CompactSet", CompactSet{A}, CompactSet{B});
+    }
+}
+
+// Lifetime and operations of n tiny sets: Set against SmallSet<16>, whose values are stored inline
+void bench_small(size_t n) {
+    std::cout << "n = " << n << " sets (nanoseconds per set)\n\n";
+    std::cout << std::left << std::setw(14) << "set" << std::right << std::setw(12) << "empty" << std::setw(12)
+              << "8 inserts" << std::setw(12) << "copy" << std::setw(12) << "+=" << std::setw(12) << "*=" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::mt19937 gen{11};
+    std::uniform_int_distribution<int> dist{0, 31};
+    std::vector<int> values(8 * n);
+    for (int& val : values) val = dist(gen);
+
+    auto report = [&]<typename T>(const char* name) {
+        std::cout << std::left << std::setw(14) << name << std::right;
+        std::cout << std::setw(12) << time_it([&] {
+                         for (size_t i = 0; i < n; ++i) T S;
+                     }) / n * 1e9;
+
+        std::vector<T> sets(n);
+        std::cout << std::setw(12) << time_it([&] {
+                         for (size_t i = 0; i < n; ++i) {
+                             for (size_t k = 0; k < 8; ++k) sets[i].insert(values[8 * i + k]);
+                         }
+                     }) / n * 1e9;
+
+        std::vector<T> copies(n);
+        std::cout << std::setw(12) << time_it([&] {
+                         for (size_t i = 0; i < n; ++i) copies[i] = sets[i];
+                     }) / n * 1e9;
+        std::cout << std::setw(12) << time_it([&] {
+                         for (size_t i = 0; i + 1 < n; ++i) copies[i] += sets[i + 1];
+                     }) / n * 1e9;
+        std::cout << std::setw(12) << time_it([&] {
+                         for (size_t i = 0; i + 1 < n; ++i) copies[i] *= sets[i + 1];
+                     }) / n * 1e9 << "\n";
+    };
+
+    report.template operator()<Set>("Set");
+    report.template operator()<SmallSet<16>>("SmallSet<16>");
+}
+
+// Window queries on a Set with n dense values: count and sum of the values in 1000 windows of about 100 values
+void bench_range(size_t n) {
+    const std::vector<int> A = make_values("dense", n, 1);
+    Set S{A};
+    Set S_indexed{A};
+    S_indexed.enable_index();
+    S_indexed.is_member(0);  // build the lanes before the clock starts
+    const FlatSet F{A};
+
+    std::mt19937 gen{13};
+    std::uniform_int_distribution<int> dist{A.front(), A.back()};
+    std::vector<int> windows(1000);
+    for (int& lo : windows) lo = dist(gen);
+    constexpr int width = 110;  // about 100 dense values
+
+    std::cout << "n = " << n << " values, " << windows.size() << " windows (microseconds per window)\n\n";
+    std::cout << std::left << std::setw(44) << "query" << std::right << std::setw(10) << "count" << std::setw(10)
+              << "sum" << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    volatile long long result = 0;
+    auto report = [&](const char* name, auto count, auto sum) {
+        std::cout << std::left << std::setw(44) << name << std::right;
+        std::cout << std::setw(10) << time_it([&] {
+                         for (int lo : windows) result = result + count(lo, lo + width);
+                     }) / windows.size() * 1e6;
+        std::cout << std::setw(10) << time_it([&] {
+                         for (int lo : windows) result = result + sum(lo, lo + width);
+                     }) / windows.size() * 1e6 << "\n";
+    };
+    auto sum_of = [](auto&& values) { return std::accumulate(values.begin(), values.end(), 0LL); };
+
+    report(
+        "scan from the first value, copy the window", [&](int lo, int hi) {
+            return std::ranges::count_if(S, [&](int val) { return lo <= val && val <= hi; });
+        },
+        [&](int lo, int hi) {
+            std::vector<int> V;
+            std::ranges::copy_if(S, std::back_inserter(V), [&](int val) { return lo <= val && val <= hi; });
+            return sum_of(V);
+        });
+    report(
+        "Set::count_range and Set::range",
+        [&](int lo, int hi) { return S.count_range(lo, hi); },
+        [&](int lo, int hi) { return sum_of(S.range(lo, hi)); });
+    report(
+        "Set::count_range and Set::range, indexed",
+        [&](int lo, int hi) { return S_indexed.count_range(lo, hi); },
+        [&](int lo, int hi) { return sum_of(S_indexed.range(lo, hi)); });
+    report(
+        "FlatSet::count_range and FlatSet::range",
+        [&](int lo, int hi) { return F.count_range(lo, hi); },
+        [&](int lo, int hi) { return sum_of(F.range(lo, hi)); });
+}
+
+// Membership of m random queries in a Set with n dense values: is_member in a loop against one batch
+void bench_batch(size_t n) {
+    const std::vector<int> A = make_values("dense", n, 1);
+    const Set S{A};
+    Set S_indexed{A};
+    S_indexed.enable_index();
+    S_indexed.is_member(0);  // build the lanes before the clock starts
+
+    std::cout << "n = " << n << " values (seconds)\n\n";
+    std::cout << std::left << std::setw(40) << "query" << std::right << std::setw(10) << "m = 1e3" << std::setw(10)
+              << "m = 1e5" << "\n";
+    std::cout << std::fixed << std::setprecision(4);
+
+    std::mt19937 gen{17};
+    std::uniform_int_distribution<int> dist{A.front(), A.back()};
+    std::vector<int> small(1000), large(100000);
+    for (int& val : small) val = dist(gen);
+    for (int& val : large) val = dist(gen);
+
+    volatile size_t found = 0;
+    auto report = [&](const char* name, auto probe) {
+        std::cout << std::left << std::setw(40) << name << std::right;
+        for (const std::vector<int>* queries : {&small, &large}) {
+            std::vector<std::uint64_t> bitmap((queries->size() + 63) / 64);
+            std::cout << std::setw(10) << time_it([&] { probe(*queries, bitmap); });
+            found = found + std::accumulate(bitmap.begin(), bitmap.end(), size_t{0},
+                                            [](size_t sum, std::uint64_t w) { return sum + std::popcount(w); });
+        }
+        std::cout << "\n";
+    };
+
+    report("is_member in a loop, indexed", [&](const std::vector<int>& Q, std::vector<std::uint64_t>& bitmap) {
+        for (size_t i = 0; i < Q.size(); ++i) bitmap[i / 64] |= std::uint64_t{S_indexed.is_member(Q[i])} << (i % 64);
+    });
+    report("batch, unsorted queries", [&](const std::vector<int>& Q, std::vector<std::uint64_t>& bitmap) {
+        S.is_member(Q, bitmap);
+    });
+    report("batch, unsorted queries, indexed", [&](const std::vector<int>& Q, std::vector<std::uint64_t>& bitmap) {
+        S_indexed.is_member(Q, bitmap);
+    });
+    std::sort(small.begin(), small.end());
+    std::sort(large.begin(), large.end());
+    report("batch, sorted queries", [&](const std::vector<int>& Q, std::vector<std::uint64_t>& bitmap) {
+        S.is_member(Q, bitmap);
+    });
+
+    // Without express lanes, each call walks from the first value: time a few calls only
+    const size_t calls = 100;
+    volatile bool member = false;
+    const double secs = time_it([&] {
+        for (size_t i = 0; i < calls; ++i) member = S.is_member(large[i * 997 % large.size()]);
+    });
+    std::cout << std::left << std::setw(40) << "is_member in a loop (estimated)" << std::right << std::setw(10)
+              << secs / calls * small.size() << std::setw(10) << secs / calls * large.size() << "\n";
+}
+
+// Core scaling of the multi-threaded FlatSet operations, for two FlatSets with n values each (half of them shared)
+// for 1, 2, 4, ... threads up to the number of hardware threads (at least 4)
+void bench_merge_path(size_t n) {
+    std::vector<int> A, B;
+    A.reserve(n);
+    B.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        A.push_back(static_cast<int>(2 * i));
+        B.push_back(static_cast<int>(2 * i + (i % 2 == 0 ? 0 : 2 * n + 1)));
+    }
+    std::sort(B.begin(), B.end());
+    const FlatSet F1{A};
+    const FlatSet F2{B};
+
+    std::cout << "n = " << n << " values, " << default_thread_count()
+              << " hardware threads (seconds, speedup against 1 thread)\n\n";
+    std::cout << std::left << std::setw(10) << "threads" << std::right << std::setw(10) << "unite" << std::setw(8) << ""
+              << std::setw(10) << "intersect" << std::setw(8) << "" << std::setw(10) << "subtract" << std::setw(8) << ""
+              << "\n";
+    std::cout << std::fixed;
+
+    std::array<double, 3> base{};
+    const unsigned max_threads = std::max(4u, default_thread_count());
+    for (unsigned n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        std::cout << std::left << std::setw(10) << n_threads << std::right;
+        for (int op = 0; op < 3; ++op) {
+            FlatSet result{F1};
+            const double secs = time_it([&] {
+                if (op == 0) result.unite(F2, n_threads);
+                if (op == 1) result.intersect(F2, n_threads);
+                if (op == 2) result.subtract(F2, n_threads);
+            });
+            if (n_threads == 1) base[op] = secs;
+            std::cout << std::setprecision(4) << std::setw(10) << secs << std::setprecision(2) << std::setw(7)
+                      << base[op] / secs << "x";
+        }
+        std::cout << "\n";
+    }
+}
+
+// is_member on a Set with n values (the even ints), when 95% of the queries are absent values (odd ints)
+// with and without express lanes and Bloom filter
+void bench_bloom(size_t n) {
+    std::vector<int> A(n);
+    for (size_t i = 0; i < n; ++i) A[i] = static_cast<int>(2 * i);
+
+    std::mt19937 gen{19};
+    std::uniform_int_distribution<int> dist{0, static_cast<int>(n) - 1};
+    std::bernoulli_distribution present{0.05};
+    std::vector<int> queries(10000);
+    for (int& val : queries) val = 2 * dist(gen) + (present(gen) ? 0 : 1);
+
+    std::cout << "n = " << n << " values, " << queries.size()
+              << " queries, 95% of absent values (microseconds per query)\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    volatile size_t found = 0;
+    auto report = [&](const char* name, bool index, bool filter) {
+        Set S{A};
+        if (index) S.enable_index();
+        if (filter) S.enable_filter();
+        S.is_member(0);  // build the lanes and the filter before the clock starts
+        const size_t m = (index || filter) ? queries.size() : 100;  // a plain Set walks the list: time a few queries
+        const double secs = time_it([&] {
+            for (size_t i = 0; i < m; ++i) found = found + S.is_member(queries[i]);
+        });
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << secs / m * 1e6 << "\n";
+    };
+
+    report("Set", false, false);
+    report("Set with express lanes", true, false);
+    report("Set with Bloom filter", false, true);
+    report("Set with express lanes and Bloom filter", true, true);
+}
+
+// Memory per key and throughput of +=, *= and -= for PackedSet against sorted vectors of 64-bit keys,
+// with the heap bytes of a Set with as many values for reference
+// The large arrays of PackedSet and vector are mapped outside of the heap counted by heap_bytes: their sizes are used
+void bench_packed(size_t n) {
+    std::cout << "PackedSet and sorted std::vector<std::uint64_t> with n = " << n
+              << " (bytes per key, Mkeys/s)\n\n";
+    std::cout << std::left << std::setw(12) << "data" << std::setw(12) << "set" << std::right << std::setw(10)
+              << "bytes" << std::setw(10) << "+=" << std::setw(10) << "*=" << std::setw(10) << "-="
+              << "\n";
+    std::cout << std::fixed << std::setprecision(2);
+
+    // 64-bit keys from the int distributions, above 2^40; sparse keys are spread over [0, 2^40)
+    auto make_keys = [n](const std::string& distribution, unsigned seed) {
+        std::vector<std::uint64_t> keys;
+        if (distribution == "sparse") {
+            std::mt19937_64 gen{seed};
+            std::uniform_int_distribution<std::uint64_t> dist{0, (std::uint64_t{1} << 40) - 1};
+            keys.resize(n);
+            for (std::uint64_t& key : keys) key = dist(gen);
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        } else {
+            for (int val : make_values(distribution, n, seed)) {
+                keys.push_back((std::uint64_t{1} << 40) + static_cast<std::uint32_t>(val));
+            }
+        }
+        return keys;
+    };
+
+    for (std::string distribution : {"dense", "sparse", "clustered"}) {
+        const std::vector<std::uint64_t> A = make_keys(distribution, 1);
+        const std::vector<std::uint64_t> B = make_keys(distribution, 2);
+        const double keys = static_cast<double>(A.size() + B.size());
+
+        auto row = [&](const char* name, double bytes, auto unite, auto intersect, auto subtract) {
+            std::cout << std::left << std::setw(12) << distribution << std::setw(12) << name << std::right
+                      << std::setw(10) << bytes;
+            for (const auto& op : {std::function<void()>{unite}, std::function<void()>{intersect},
+                                   std::function<void()>{subtract}}) {
+                std::cout << std::setw(10) << keys / time_it(op) / 1e6;
+            }
+            std::cout << "\n";
+        };
+
+        const PackedSet P1{A};
+        const PackedSet P2{B};
+        row("PackedSet", static_cast<double>(P1.encoded_bytes()) / A.size(),
+            [&] { PackedSet R{P1}; R += P2; }, [&] { PackedSet R{P1}; R *= P2; }, [&] { PackedSet R{P1}; R -= P2; });
+
+        auto merge = [&](auto algorithm) {
+            std::vector<std::uint64_t> R;
+            R.reserve(A.size() + B.size());
+            algorithm(A.begin(), A.end(), B.begin(), B.end(), std::back_inserter(R));
+        };
+        row("vector", static_cast<double>(sizeof(std::uint64_t) * A.capacity()) / A.size(),
+            [&] { merge([](auto... args) { std::set_union(args...); }); },
+            [&] { merge([](auto... args) { std::set_intersection(args...); }); },
+            [&] { merge([](auto... args) { std::set_difference(args...); }); });
+
+        std::vector<int> V(A.size());
+        std::iota(V.begin(), V.end(), 0);
+        std::cout << std::left << std::setw(12) << distribution << std::setw(12) << "Set" << std::right
+                  << std::setw(10) << static_cast<double>(heap_bytes<Set>([&] { return Set{V}; })) / A.size()
+                  << "\n";
+    }
+}
+
+// Read back a dump of a Set with n sparse values, written by operator<<: operator>> against istream extraction of ints
+// n = 300'000'000 writes a dump of about 3.4 GB, and needs about 20 GB of memory for the two Sets
+void bench_parse(size_t n) {
+    const auto file = std::filesystem::temp_directory_path() / "lab2_bench_parse.txt";
+    {
+        std::ofstream os{file};
+        os << Set{make_values("sparse", n, 1)} << "\n";
+    }
+    const double mb = std::filesystem::file_size(file) / 1e6;
+    std::cout << "Dump of a Set with n = " << n << " values, " << mb << " MB (seconds, MB/s)\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    auto report = [&](const char* name, double secs) {
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << secs << std::setw(10)
+                  << std::setprecision(0) << mb / secs << std::setprecision(3) << "\n";
+    };
+
+    Set S1;
+    report("operator>>", time_it([&] {
+               std::ifstream is{file};
+               is >> S1;
+           }));
+
+    Set S2;
+    report("istream >> int, Set(std::vector<int>)", time_it([&] {
+               std::ifstream is{file};
+               char brace = 0;
+               is >> brace;
+               std::vector<int> values;
+               for (int val = 0; is >> val;) values.push_back(val);
+               S2 = Set{values};
+           }));
+
+    std::cout << (S1 == S2 && S1.cardinality() == n ? "" : "Error: different Sets\n");
+    std::filesystem::remove(file);
+}
+
+// Bursts of 1000 random insertions into an empty set, each followed by one is_member, up to n values
+// Set::insert and += Set{val} walk the list for each value: only the first 20000 insertions are timed for them
+void bench_buffered(size_t n) {
+    std::mt19937 gen{50};
+    std::uniform_int_distribution<int> dist{0, std::numeric_limits<int>::max()};
+    std::vector<int> values(n);
+    for (int& val : values) val = dist(gen);
+    std::vector<int> increasing(n);  // e.g. ids or timestamps
+    std::iota(increasing.begin(), increasing.end(), 0);
+
+    std::cout << "n = " << n << " insertions, in bursts of 1000 followed by is_member (microseconds per insertion)\n\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    volatile bool found = false;
+    auto report = [&]<typename T>(const char* name, size_t m, auto insert, const std::vector<int>& keys = {}) {
+        const std::vector<int>& V = keys.empty() ? values : keys;
+        T S;
+        const double secs = time_it([&] {
+            for (size_t i = 0; i < m; ++i) {
+                insert(S, V[i]);
+                if (i % 1000 == 999) found = S.is_member(V[i / 2]);
+            }
+        });
+        std::cout << std::left << std::setw(40) << name << std::right << std::setw(10) << secs / m * 1e6
+                  << std::setw(12) << m << " values\n";
+    };
+
+    const size_t m = std::min<size_t>(n, 20000);
+    report.operator()<Set>("Set::insert", m, [](Set& S, int val) { S.insert(val); });
+    report.operator()<Set>("Set += Set{val}", m, [](Set& S, int val) { S += Set{val}; });
+    report.operator()<BufferedSet>("BufferedSet::insert", n, [](BufferedSet& S, int val) { S.insert(val); });
+    report.operator()<BufferedSet>("BufferedSet += BufferedSet{val}", n,
+                                   [](BufferedSet& S, int val) { S += BufferedSet{val}; });
+    report.operator()<BufferedSet>("BufferedSet::insert, increasing keys", n,
+                                   [](BufferedSet& S, int val) { S.insert(val); }, increasing);
+}
+
+// Ordering by set inclusion of two sorted containers, as operator<=> of class Set
+template <typename C>
+std::partial_ordering inclusion_order(const C& a, const C& b) {
+    if (a.size() == b.size()) {
+        return (a == b) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+    if (a.size() < b.size()) {
+        return std::includes(b.begin(), b.end(), a.begin(), a.end()) ? std::partial_ordering::less
+                                                                       : std::partial_ordering::unordered;
+    }
+    return std::includes(a.begin(), a.end(), b.begin(), b.end()) ? std::partial_ordering::greater
+                                                                   : std::partial_ordering::unordered;
+}
+
+/*
+ * The operations measured by bench_suite, for the classes with the interface of class Set
+ * The specializations below map them to std::set, std::flat_set and sorted vectors with the std algorithms
+ */
+template <typename T>
+struct SuiteOps {
+    static T build(const std::vector<int>& V) { return T{V}; }
+    static bool member(const T& S, int val) { return S.is_member(val); }
+    static std::partial_ordering order(const T& S1, const T& S2) { return S1 <=> S2; }
+    static void unite(T& S1, const T& S2) { S1 += S2; }
+    static void intersect(T& S1, const T& S2) { S1 *= S2; }
+    static void subtract(T& S1, const T& S2) { S1 -= S2; }
+    static void clear(T& S) { S.make_empty(); }
+};
+
+template <>
+struct SuiteOps<std::set<int>> {
+    using T = std::set<int>;
+    static T build(const std::vector<int>& V) { return T(V.begin(), V.end()); }  // linear for sorted input
+    static bool member(const T& S, int val) { return S.contains(val); }
+    static std::partial_ordering order(const T& S1, const T& S2) { return inclusion_order(S1, S2); }
+    static void unite(T& S1, const T& S2) {
+        T result;
+        std::set_union(S1.begin(), S1.end(), S2.begin(), S2.end(), std::inserter(result, result.end()));
+        S1.swap(result);
+    }
+    static void intersect(T& S1, const T& S2) {
+        T result;
+        std::set_intersection(S1.begin(), S1.end(), S2.begin(), S2.end(), std::inserter(result, result.end()));
+        S1.swap(result);
+    }
+    static void subtract(T& S1, const T& S2) {
+        T result;
+        std::set_difference(S1.begin(), S1.end(), S2.begin(), S2.end(), std::inserter(result, result.end()));
+        S1.swap(result);
+    }
+    static void clear(T& S) { S.clear(); }
+};
+
+template <>
+struct SuiteOps<std::vector<int>> {
+    using T = std::vector<int>;
+    static T build(const std::vector<int>& V) { return V; }
+    static bool member(const T& S, int val) { return std::binary_search(S.begin(), S.end(), val); }
+    static std::partial_ordering order(const T& S1, const T& S2) { return inclusion_order(S1, S2); }
+    static void unite(T& S1, const T& S2) {
+        T result;
+        result.reserve(S1.size() + S2.size());
+        std::set_union(S1.begin(), S1.end(), S2.begin(), S2.end(), std::back_inserter(result));
+        S1.swap(result);
+    }
+    static void intersect(T& S1, const T& S2) {
+        T result;
+        result.reserve(std::min(S1.size(), S2.size()));
+        std::set_intersection(S1.begin(), S1.end(), S2.begin(), S2.end(), std::back_inserter(result));
+        S1.swap(result);
+    }
+    static void subtract(T& S1, const T& S2) {
+        T result;
+        result.reserve(S1.size());
+        std::set_difference(S1.begin(), S1.end(), S2.begin(), S2.end(), std::back_inserter(result));
+        S1.swap(result);
+    }
+    static void clear(T& S) { S.clear(); }
+};
+
+#if defined(__cpp_lib_flat_set)
+template <>
+struct SuiteOps<std::flat_set<int>> {
+    using T = std::flat_set<int>;
+    using Vector = SuiteOps<std::vector<int>>;
+    static T build(const std::vector<int>& V) { return T(std::sorted_unique, V.begin(), V.end()); }
+    static bool member(const T& S, int val) { return S.contains(val); }
+    static std::partial_ordering order(const T& S1, const T& S2) { return inclusion_order(S1, S2); }
+    static void unite(T& S1, const T& S2) { apply(S1, S2, Vector::unite); }
+    static void intersect(T& S1, const T& S2) { apply(S1, S2, Vector::intersect); }
+    static void subtract(T& S1, const T& S2) { apply(S1, S2, Vector::subtract); }
+    static void clear(T& S) { S.clear(); }
+
+    // Run a vector algorithm on the underlying sorted vectors
+    static void apply(T& S1, const T& S2, void (*op)(std::vector<int>&, const std::vector<int>&)) {
+        std::vector<int> V1 = std::move(S1).extract();
+        op(V1, S2.keys());
+        S1.replace(std::move(V1));
+    }
+};
+#endif
+
+constexpr std::array<const char*, 9> suite_operations{"construct", "copy",   "is_member", "==",        "<=>",
+                                                      "+=",        "*=",     "-=",        "make_empty"};
+
+/*
+ * Nanoseconds per element of each operation of suite_operations, for two sets with the values of A and B
+ * Per element of A for construct, copy and make_empty, per lookup for is_member, per element of both operands otherwise
+ * Small sets are measured several times, so that each measure handles about 1e6 elements;
+ * the copies that are modified, or destroyed, are made before the clock starts
+ */
+template <typename T>
+std::array<double, 9> suite_measure(const std::vector<int>& A, const std::vector<int>& B,
+                                    const std::vector<int>& queries) {
+    using Ops = SuiteOps<T>;
+    const size_t reps = std::max<size_t>(1, 1'000'000 / A.size());
+    const double n = static_cast<double>(A.size() * reps);
+    const double n2 = static_cast<double>((A.size() + B.size()) * reps);
+    const T S1 = Ops::build(A);
+    const T S2 = Ops::build(B);
+    const T S1_copy = Ops::build(A);
+    T S1_and_S2 = Ops::build(A);
+    Ops::intersect(S1_and_S2, S2);
+
+    std::array<double, 9> ns{};
+    std::vector<T> out(reps);
+    ns[0] = time_it([&] {
+                for (T& S : out) S = Ops::build(A);
+            }) / n;
+    out = std::vector<T>(reps);
+    ns[1] = time_it([&] {
+                for (T& S : out) S = S1;
+            }) / n;
+
+    volatile size_t found = 0;
+    ns[2] = time_it([&] {
+                for (int val : queries) found = found + Ops::member(S1, val);
+            }) / static_cast<double>(queries.size());
+
+    volatile bool equal = false;
+    ns[3] = time_it([&] {
+                for (size_t r = 0; r < reps; ++r) equal = (S1 == S1_copy);  // equal sets: full traversal
+            }) / n2;
+    volatile bool subset = false;
+    ns[4] = time_it([&] {
+                for (size_t r = 0; r < reps; ++r) subset = (Ops::order(S1_and_S2, S1) <= 0);
+            }) / n2;
+
+    for (int op = 0; op < 4; ++op) {
+        out.assign(reps, S1);
+        ns[5 + op] = time_it([&] {
+                         for (T& S : out) {
+                             if (op == 0) Ops::unite(S, S2);
+                             if (op == 1) Ops::intersect(S, S2);
+                             if (op == 2) Ops::subtract(S, S2);
+                             if (op == 3) Ops::clear(S);
+                         }
+                     }) / (op == 3 ? n : n2);
+    }
+
+    for (double& t : ns) t *= 1e9;
+    return ns;
+}
+
+/*
+ * Two sorted vectors of n values each, with distribution as in make_values, sharing about overlap * n values
+ */
+std::pair<std::vector<int>, std::vector<int>> make_pair_of_values(const std::string& distribution, size_t n,
+                                                                  double overlap, unsigned seed) {
+    std::vector<int> pool = make_values(distribution, 2 * n, seed);
+    std::shuffle(pool.begin(), pool.end(), std::mt19937{seed});
+    const size_t shared = static_cast<size_t>(overlap * n);
+
+    std::vector<int> A(pool.begin(), pool.begin() + n);
+    std::vector<int> B(pool.begin(), pool.begin() + shared);
+    B.insert(B.end(), pool.begin() + n, pool.begin() + (2 * n - shared));
+    std::sort(A.begin(), A.end());
+    std::sort(B.begin(), B.end());
+    return {A, B};
+}
+
+// Every operation of Set, FlatSet, std::set, std::flat_set (when the library has it) and sorted vectors
+// with the std algorithms, for 1e2, 1e3, ... n values (up to 1e7 by default), several overlaps and distributions
+// The table is printed and written to lab2_bench_suite.csv, in the current directory, for regression tracking
+void bench_suite(size_t n) {
+    const std::filesystem::path csv_file = "lab2_bench_suite.csv";
+    std::ofstream csv{csv_file};
+    csv << "distribution,n,overlap,set,operation,ns_per_element\n";
+
+    std::cout << "Set operations (nanoseconds per element)\n\n";
+    std::cout << std::left << std::setw(11) << "data" << std::right << std::setw(9) << "n" << std::setw(8)
+              << "overlap" << "  " << std::left << std::setw(15) << "set" << std::right;
+    for (const char* op : suite_operations) std::cout << std::setw(11) << op;
+    std::cout << "\n";
+
+    for (std::string distribution : {"dense", "sparse", "clustered"}) {
+        for (size_t size = 100; size <= n; size *= 10) {
+            for (double overlap : {0.1, 0.5, 0.9}) {
+                const auto [A, B] = make_pair_of_values(distribution, size, overlap, 1);
+                std::mt19937 gen{2};
+                std::uniform_int_distribution<int> dist{A.front(), A.back()};
+                std::vector<int> queries(std::clamp<size_t>(10'000'000 / size, 10, 100'000));
+                for (int& val : queries) val = dist(gen);
+
+                auto report = [&]<typename T>(const char* name) {
+                    const std::array<double, 9> ns = suite_measure<T>(A, B, queries);
+                    std::cout << std::left << std::setw(11) << distribution << std::right << std::setw(9) << size
+                              << std::fixed << std::setprecision(1) << std::setw(8) << overlap << "  " << std::left
+                              << std::setw(15) << name << std::right << std::setprecision(2);
+                    for (size_t i = 0; i < ns.size(); ++i) {
+                        std::cout << std::setw(11) << ns[i];
+                        csv << distribution << ',' << size << ',' << overlap << ',' << name << ','
+                            << suite_operations[i] << ',' << ns[i] << '\n';
+                    }
+                    std::cout << "\n";
+                };
+
+                report.template operator()<Set>("Set");
+                report.template operator()<FlatSet>("FlatSet");
+                report.template operator()<std::set<int>>("std::set");
+#if defined(__cpp_lib_flat_set)
+                report.template operator()<std::flat_set<int>>("std::flat_set");
+#endif
+                report.template operator()<std::vector<int>>("vector");
+            }
+        }
+    }
+    std::cout << "\nResults written to " << std::filesystem::absolute(csv_file) << "\n";
+}
+
+/****************************************
+ * Main                                  *
+ *****************************************/
+
+struct Benchmark {
+    const char* name;
+    const char* description;
+    size_t default_n;
+    void (*run)(size_t n);
+};
+
+const std::vector<Benchmark> benchmarks{
+    {"bitmap", "memory and throughput of Set, FlatSet and BitmapSet", 1'000'000, bench_bitmap},
+    {"load", "bulk construction from unsorted ints and from a file", 10'000'000, bench_load},
+    {"kway", "union and intersection of many Sets, pairwise and k-way", 10'000, bench_kway},
+    {"concurrent", "read and write scaling of ConcurrentSet against a Set guarded by a mutex", 1'000, bench_concurrent},
+    {"persistent", "snapshots and operations on snapshots of Set and PersistentSet", 1'000'000, bench_persistent},
+    {"queries", "intersection size with and without building the intersection", 1'000'000, bench_queries},
+    {"stream", "streaming sorted values into a Set, with and without a position hint", 20'000, bench_stream},
+    {"file", "size and load time of text and binary Set files", 5'000'000, bench_file},
+    {"unrolled", "memory and traversal speed of Set, UnrolledSet and CompactSet", 1'000'000, bench_unrolled},
+    {"small", "lifetime and operations of tiny sets: Set against SmallSet", 1'000'000, bench_small},
+    {"range", "window queries: count and sum of the values in [lo, hi]", 1'000'000, bench_range},
+    {"batch", "membership of many queries: is_member in a loop against one batch", 1'000'000, bench_batch},
+    {"mergepath", "core scaling of the multi-threaded FlatSet operations", 10'000'000, bench_merge_path},
+    {"bloom", "is_member with 95% of absent values, with and without a Bloom filter", 1'000'000, bench_bloom},
+    {"packed", "memory and throughput of PackedSet, against sorted vectors of 64-bit keys", 1'000'000, bench_packed},
+    {"parse", "operator>> on a dump written by operator<<, against istream extraction of ints", 10'000'000,
+     bench_parse},
+    {"buffered", "bursts of insertions into Set and BufferedSet", 1'000'000, bench_buffered},
+    {"suite", "every Set operation against std::set, std::flat_set and sorted vectors, exported as CSV", 10'000'000,
+     bench_suite},
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: Lab2Bench <benchmark> [n]\n";
+        for (const Benchmark& b : benchmarks) {
+            std::cout << "  " << std::left << std::setw(12) << b.name << b.description << "\n";
+        }
+        return 0;
+    }
+
+    for (const Benchmark& b : benchmarks) {
+        if (std::string{argv[1]} == b.name) {
+            b.run((argc > 2) ? std::strtoull(argv[2], nullptr, 10) : b.default_n);
+            if constexpr (settelemetry::enabled) {
+                std::cout << "\nTelemetry: " << settelemetry::snapshot().to_json() << "\n";
+            }
+            return 0;
+        }
+    }
+    std::cerr << "Unknown benchmark: " << argv[1] << "\n";
+    return 1;
+}
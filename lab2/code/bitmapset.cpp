@@ -0,0 +1,722 @@
+#include "bitmapset.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+namespace {
+
+/*
+ * A value is mapped to an unsigned int with the same order (the sign bit is flipped)
+ * The 16 high bits are the key of its container, the 16 low bits are stored in the container
+ */
+std::uint32_t to_unsigned(int val) {
+    return static_cast<std::uint32_t>(val) ^ 0x80000000u;
+}
+
+int to_int(std::uint16_t key, std::uint16_t low) {
+    return static_cast<int>(((static_cast<std::uint32_t>(key) << 16) | low) ^ 0x80000000u);
+}
+
+std::uint16_t key_of(int val) {
+    return static_cast<std::uint16_t>(to_unsigned(val) >> 16);
+}
+
+std::uint16_t low_of(int val) {
+    return static_cast<std::uint16_t>(to_unsigned(val) & 0xFFFFu);
+}
+
+}  // namespace
+
+/** Class BitmapSet::ChunkOps
+ *
+ * Algorithms on the containers (chunks) of a BitmapSet
+ * All functions are static
+ */
+class BitmapSet::ChunkOps {
+public:
+    static constexpr std::uint8_t array = 0;
+    static constexpr std::uint8_t bitmap = 1;
+    static constexpr std::uint8_t run = 2;
+
+    static constexpr std::size_t n_words = 1024;      // 2^16 bits
+    static constexpr std::uint32_t max_array = 4096;  // an array is never larger than a bitmap
+
+    using Words = std::vector<std::uint64_t>;
+    using Lows = std::vector<std::uint16_t>;
+
+    /*
+     * Test whether low belongs to chunk c
+     */
+    static bool contains(const Chunk& c, std::uint16_t low) {
+        switch (c.kind) {
+            case array:
+                return std::binary_search(c.data.begin(), c.data.end(), low);
+            case bitmap:
+                return (c.words[low / 64] >> (low % 64)) & 1u;
+            default: {
+                // Find the last run starting at most at low
+                std::size_t lo = 0, hi = c.data.size() / 2;
+                while (lo < hi) {
+                    std::size_t mid = (lo + hi) / 2;
+                    if (c.data[2 * mid] <= low)
+                        lo = mid + 1;
+                    else
+                        hi = mid;
+                }
+                return lo > 0 && low - c.data[2 * (lo - 1)] <= c.data[2 * (lo - 1) + 1];
+            }
+        }
+    }
+
+    /*
+     * Call f(low) for every value in chunk c, in increasing order
+     */
+    template <typename F>
+    static void for_each(const Chunk& c, F f) {
+        switch (c.kind) {
+            case array:
+                for (std::uint16_t low : c.data) f(low);
+                break;
+            case bitmap:
+                for (std::size_t i = 0; i < n_words; ++i) {
+                    for (std::uint64_t w = c.words[i]; w != 0; w &= w - 1) {
+                        f(static_cast<std::uint16_t>(64 * i + std::countr_zero(w)));
+                    }
+                }
+                break;
+            default:
+                for (std::size_t i = 0; i < c.data.size(); i += 2) {
+                    const std::uint32_t start = c.data[i];
+                    for (std::uint32_t low = start; low <= start + c.data[i + 1]; ++low) {
+                        f(static_cast<std::uint16_t>(low));
+                    }
+                }
+        }
+    }
+
+    /*
+     * Return the bitmap of the values in chunk c
+     */
+    static Words to_words(const Chunk& c) {
+        if (c.kind == bitmap) return c.words;
+
+        Words w(n_words, 0);
+        if (c.kind == array) {
+            set_bits(w, c.data);
+        } else {
+            for (std::size_t i = 0; i < c.data.size(); i += 2) {
+                set_range(w, c.data[i], c.data[i] + c.data[i + 1]);
+            }
+        }
+        return w;
+    }
+
+    static void set_bits(Words& w, const Lows& lows) {
+        for (std::uint16_t low : lows) {
+            w[low / 64] |= std::uint64_t{1} << (low % 64);
+        }
+    }
+
+    static void clear_bits(Words& w, const Lows& lows) {
+        for (std::uint16_t low : lows) {
+            w[low / 64] &= ~(std::uint64_t{1} << (low % 64));
+        }
+    }
+
+    // Set the bits first..last (inclusive)
+    static void set_range(Words& w, std::uint32_t first, std::uint32_t last) {
+        for (std::uint32_t i = first / 64; i <= last / 64; ++i) {
+            std::uint64_t mask = ~std::uint64_t{0};
+            if (i == first / 64) mask &= ~std::uint64_t{0} << (first % 64);
+            if (i == last / 64) mask &= ~std::uint64_t{0} >> (63 - last % 64);
+            w[i] |= mask;
+        }
+    }
+
+    /*
+     * Store the sorted values lows in chunk c, using the smallest representation
+     */
+    static void assign(Chunk& c, Lows&& lows) {
+        const std::uint32_t card = static_cast<std::uint32_t>(lows.size());
+        std::uint32_t runs = (card == 0) ? 0 : 1;
+        for (std::size_t i = 1; i < lows.size(); ++i) {
+            runs += (lows[i] != lows[i - 1] + 1);
+        }
+
+        c.card = card;
+        c.runs = runs;
+        c.words.clear();
+        c.words.shrink_to_fit();
+        if (kind_for(card, runs) == run) {
+            c.kind = run;
+            c.data = runs_of(lows, runs);
+        } else if (card <= max_array) {
+            c.kind = array;
+            c.data = std::move(lows);
+        } else {
+            Words w(n_words, 0);
+            set_bits(w, lows);
+            c.kind = bitmap;
+            c.data.clear();
+            c.data.shrink_to_fit();
+            c.words = std::move(w);
+        }
+    }
+
+    /*
+     * Store the values of bitmap w in chunk c, using the smallest representation
+     */
+    static void assign(Chunk& c, Words&& w) {
+        std::uint32_t card = 0;
+        std::uint32_t runs = 0;
+        std::uint64_t carry = 0;  // highest bit of the previous word
+        for (std::uint64_t word : w) {
+            card += static_cast<std::uint32_t>(std::popcount(word));
+            runs += static_cast<std::uint32_t>(std::popcount(word & ~((word << 1) | carry)));  // run starts
+            carry = word >> 63;
+        }
+
+        if (kind_for(card, runs) != bitmap) {
+            Chunk tmp{c.key, bitmap, card, runs, {}, std::move(w)};
+            Lows lows;
+            lows.reserve(card);
+            for_each(tmp, [&lows](std::uint16_t low) { lows.push_back(low); });
+            assign(c, std::move(lows));
+        } else {
+            c.kind = bitmap;
+            c.card = card;
+            c.runs = runs;
+            c.data.clear();
+            c.data.shrink_to_fit();
+            c.words = std::move(w);
+        }
+    }
+
+    /*
+     * x becomes x union y
+     */
+    static void unite(Chunk& x, const Chunk& y) {
+        if (x.kind == array && y.kind == array) {
+            Lows lows;
+            lows.reserve(x.data.size() + y.data.size());
+            std::set_union(x.data.begin(), x.data.end(), y.data.begin(), y.data.end(),
+                           std::back_inserter(lows));
+            assign(x, std::move(lows));
+            return;
+        }
+
+        Words w = to_words(x);
+        if (y.kind == bitmap) {
+            for (std::size_t i = 0; i < n_words; ++i) w[i] |= y.words[i];
+        } else if (y.kind == array) {
+            set_bits(w, y.data);
+        } else {
+            for (std::size_t i = 0; i < y.data.size(); i += 2) {
+                set_range(w, y.data[i], y.data[i] + y.data[i + 1]);
+            }
+        }
+        assign(x, std::move(w));
+    }
+
+    /*
+     * x becomes x intersection y
+     */
+    static void intersect(Chunk& x, const Chunk& y) {
+        if (x.kind == array || y.kind == array) {
+            const Chunk& a = (x.kind == array) ? x : y;  // filter the values of an array
+            const Chunk& other = (x.kind == array) ? y : x;
+            Lows lows;
+            lows.reserve(a.data.size());
+            if (other.kind == array) {
+                std::set_intersection(a.data.begin(), a.data.end(), other.data.begin(),
+                                      other.data.end(), std::back_inserter(lows));
+            } else {
+                std::copy_if(a.data.begin(), a.data.end(), std::back_inserter(lows),
+                             [&other](std::uint16_t low) { return contains(other, low); });
+            }
+            assign(x, std::move(lows));
+            return;
+        }
+
+        Words w = to_words(x);
+        const Words wy = to_words(y);
+        for (std::size_t i = 0; i < n_words; ++i) w[i] &= wy[i];
+        assign(x, std::move(w));
+    }
+
+    /*
+     * x becomes x - y
+     */
+    static void subtract(Chunk& x, const Chunk& y) {
+        if (x.kind == array) {
+            Lows lows;
+            lows.reserve(x.data.size());
+            if (y.kind == array) {
+                std::set_difference(x.data.begin(), x.data.end(), y.data.begin(), y.data.end(),
+                                    std::back_inserter(lows));
+            } else {
+                std::copy_if(x.data.begin(), x.data.end(), std::back_inserter(lows),
+                             [&y](std::uint16_t low) { return !contains(y, low); });
+            }
+            assign(x, std::move(lows));
+            return;
+        }
+
+        Words w = to_words(x);
+        if (y.kind == array) {
+            clear_bits(w, y.data);
+        } else {
+            const Words wy = to_words(y);
+            for (std::size_t i = 0; i < n_words; ++i) w[i] &= ~wy[i];
+        }
+        assign(x, std::move(w));
+    }
+
+    /*
+     * Smallest representation of card values forming runs runs of consecutive values
+     */
+    static std::uint8_t kind_for(std::uint32_t card, std::uint32_t runs) {
+        if (use_runs(card, runs)) return run;
+        return (card <= max_array) ? array : bitmap;
+    }
+
+    /*
+     * Add low, not in chunk c yet, to c
+     * The number of runs follows from the neighbours of low: the container is updated in place
+     * if its representation is still the smallest one, otherwise it is converted
+     */
+    static void add(Chunk& c, std::uint16_t low) {
+        const bool left = low > 0 && contains(c, low - 1);
+        const bool right = low < 0xFFFF && contains(c, low + 1);
+        const std::uint32_t runs = c.runs + 1 - left - right;
+
+        if (kind_for(c.card + 1, runs) != c.kind) {
+            Words w = to_words(c);
+            w[low / 64] |= std::uint64_t{1} << (low % 64);
+            assign(c, std::move(w));
+            return;
+        }
+
+        if (c.kind == array) {
+            c.data.insert(std::lower_bound(c.data.begin(), c.data.end(), low), low);
+        } else if (c.kind == bitmap) {
+            c.words[low / 64] |= std::uint64_t{1} << (low % 64);
+        } else {
+            const std::size_t i = run_after(c, low);  // runs [0, i) start before low
+            if (left && right) {                      // join runs i - 1 and i
+                c.data[2 * i - 1] = static_cast<std::uint16_t>(c.data[2 * i - 1] + c.data[2 * i + 1] + 2);
+                c.data.erase(c.data.begin() + 2 * i, c.data.begin() + 2 * i + 2);
+            } else if (left) {
+                ++c.data[2 * i - 1];
+            } else if (right) {
+                c.data[2 * i] = low;
+                ++c.data[2 * i + 1];
+            } else {
+                const std::uint16_t pair[2] = {low, 0};
+                c.data.insert(c.data.begin() + 2 * i, pair, pair + 2);
+            }
+        }
+        ++c.card;
+        c.runs = runs;
+    }
+
+    /*
+     * Remove low, a value of chunk c, from c, as add does
+     */
+    static void remove(Chunk& c, std::uint16_t low) {
+        const bool left = low > 0 && contains(c, low - 1);
+        const bool right = low < 0xFFFF && contains(c, low + 1);
+        const std::uint32_t runs = c.runs - 1 + left + right;
+
+        if (c.card == 1 || kind_for(c.card - 1, runs) != c.kind) {
+            Words w = to_words(c);
+            w[low / 64] &= ~(std::uint64_t{1} << (low % 64));
+            assign(c, std::move(w));
+            return;
+        }
+
+        if (c.kind == array) {
+            c.data.erase(std::lower_bound(c.data.begin(), c.data.end(), low));
+        } else if (c.kind == bitmap) {
+            c.words[low / 64] &= ~(std::uint64_t{1} << (low % 64));
+        } else {
+            const std::size_t i = run_after(c, low) - 1;  // run i holds low
+            const std::uint16_t start = c.data[2 * i];
+            const std::uint16_t last = static_cast<std::uint16_t>(start + c.data[2 * i + 1]);
+            if (left && right) {  // split run i
+                c.data[2 * i + 1] = static_cast<std::uint16_t>(low - 1 - start);
+                const std::uint16_t pair[2] = {static_cast<std::uint16_t>(low + 1),
+                                               static_cast<std::uint16_t>(last - low - 1)};
+                c.data.insert(c.data.begin() + 2 * i + 2, pair, pair + 2);
+            } else if (left) {
+                --c.data[2 * i + 1];
+            } else if (right) {
+                ++c.data[2 * i];
+                --c.data[2 * i + 1];
+            } else {
+                c.data.erase(c.data.begin() + 2 * i, c.data.begin() + 2 * i + 2);
+            }
+        }
+        --c.card;
+        c.runs = runs;
+    }
+
+    /*
+     * Test whether chunk x (with the same key as y) includes all values of chunk y
+     * Nothing is allocated: bitmaps are compared word by word, runs interval by interval,
+     * and otherwise the values of y are looked up in x from left to right, stopping at the first missing one
+     */
+    static bool includes(const Chunk& x, const Chunk& y) {
+        if (y.card > x.card) return false;
+
+        if (x.kind == bitmap && y.kind == bitmap) {
+            for (std::size_t i = 0; i < n_words; ++i) {
+                if ((y.words[i] & ~x.words[i]) != 0) return false;
+            }
+            return true;
+        }
+        if (x.kind == array && y.kind == array) {
+            return std::includes(x.data.begin(), x.data.end(), y.data.begin(), y.data.end());
+        }
+        if (x.kind == bitmap) {
+            return all_of(y, [&x](std::uint16_t low) { return contains(x, low); });
+        }
+        if (x.kind == array) {
+            auto it = x.data.begin();
+            return all_of(y, [&](std::uint16_t low) {
+                it = std::lower_bound(it, x.data.end(), low);
+                return it != x.data.end() && *it == low;
+            });
+        }
+
+        // x is a run container: find the run of x that ends at or after each value (or run) of y
+        std::size_t i = 0;
+        auto covered = [&](std::uint32_t first, std::uint32_t last) {
+            while (i < x.data.size() && x.data[i] + x.data[i + 1] < first) i += 2;
+            return i < x.data.size() && x.data[i] <= first && last <= x.data[i] + x.data[i + 1];
+        };
+        if (y.kind == run) {
+            for (std::size_t j = 0; j < y.data.size(); j += 2) {
+                if (!covered(y.data[j], y.data[j] + y.data[j + 1])) return false;
+            }
+            return true;
+        }
+        return all_of(y, [&](std::uint16_t low) { return covered(low, low); });
+    }
+
+    /*
+     * Test whether chunks x and y (with the same key) store the same values
+     */
+    static bool equal(const Chunk& x, const Chunk& y) {
+        if (x.card != y.card) return false;
+        if (x.kind == y.kind) {
+            return (x.kind == bitmap) ? x.words == y.words : x.data == y.data;
+        }
+        return to_words(x) == to_words(y);
+    }
+
+private:
+    /*
+     * Test whether pred(low) holds for every value in chunk c, in increasing order, stopping at the first false
+     */
+    template <typename F>
+    static bool all_of(const Chunk& c, F pred) {
+        switch (c.kind) {
+            case array:
+                return std::all_of(c.data.begin(), c.data.end(), pred);
+            case bitmap:
+                for (std::size_t i = 0; i < n_words; ++i) {
+                    for (std::uint64_t w = c.words[i]; w != 0; w &= w - 1) {
+                        if (!pred(static_cast<std::uint16_t>(64 * i + std::countr_zero(w)))) return false;
+                    }
+                }
+                return true;
+            default:
+                for (std::size_t i = 0; i < c.data.size(); i += 2) {
+                    const std::uint32_t start = c.data[i];
+                    for (std::uint32_t low = start; low <= start + c.data[i + 1]; ++low) {
+                        if (!pred(static_cast<std::uint16_t>(low))) return false;
+                    }
+                }
+                return true;
+        }
+    }
+
+    // Number of runs of run container c starting at most at low
+    static std::size_t run_after(const Chunk& c, std::uint16_t low) {
+        std::size_t lo = 0, hi = c.data.size() / 2;
+        while (lo < hi) {
+            const std::size_t mid = (lo + hi) / 2;
+            if (c.data[2 * mid] <= low)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    // A run container is used if it is smaller than the array (or the bitmap)
+    static bool use_runs(std::uint32_t card, std::uint32_t runs) {
+        const std::uint32_t run_bytes = 4 * runs;
+        const std::uint32_t other_bytes = (card <= max_array) ? 2 * card : 8 * n_words;
+        return run_bytes < other_bytes;
+    }
+
+    // Encode sorted values as pairs (start, length)
+    static Lows runs_of(const Lows& lows, std::uint32_t runs) {
+        Lows pairs;
+        pairs.reserve(2 * runs);
+        for (std::size_t i = 0; i < lows.size();) {
+            std::size_t j = i;
+            while (j + 1 < lows.size() && lows[j + 1] == lows[j] + 1) ++j;
+            pairs.push_back(lows[i]);
+            pairs.push_back(static_cast<std::uint16_t>(j - i));
+            i = j + 1;
+        }
+        return pairs;
+    }
+};
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ *  Conversion constructor: convert val into a singleton {val}
+ */
+BitmapSet::BitmapSet(int val) {
+    insert(val);
+}
+
+/*
+ * Constructor to create a BitmapSet from a sorted vector of ints
+ */
+BitmapSet::BitmapSet(const std::vector<int>& list_of_values) {
+    for (std::size_t i = 0; i < list_of_values.size();) {
+        const std::uint16_t key = key_of(list_of_values[i]);
+        ChunkOps::Lows lows;
+        for (; i < list_of_values.size() && key_of(list_of_values[i]) == key; ++i) {
+            lows.push_back(low_of(list_of_values[i]));
+        }
+        chunks.push_back(Chunk{key, ChunkOps::array, 0, 0, {}, {}});
+        ChunkOps::assign(chunks.back(), std::move(lows));
+        counter += chunks.back().card;
+    }
+}
+
+/*
+ * Constructor to create a BitmapSet with the same elements as Set S
+ */
+BitmapSet::BitmapSet(const Set& S) : BitmapSet{S.to_vector()} {
+}
+
+/*
+ * Return a Set with the same elements as the BitmapSet
+ */
+Set BitmapSet::to_set() const {
+    return Set{to_vector()};
+}
+
+/*
+ * Return a sorted vector with all ints in the BitmapSet
+ */
+std::vector<int> BitmapSet::to_vector() const {
+    std::vector<int> list_of_values;
+    list_of_values.reserve(counter);
+    for (const Chunk& c : chunks) {
+        ChunkOps::for_each(c, [&](std::uint16_t low) { list_of_values.push_back(to_int(c.key, low)); });
+    }
+    return list_of_values;
+}
+
+/*
+ * Transform the BitmapSet into an empty set
+ */
+void BitmapSet::make_empty() {
+    chunks.clear();
+    counter = 0;
+}
+
+/*
+ * Insert val, if it does not belong to the set yet
+ */
+void BitmapSet::insert(int val) {
+    const std::uint16_t key = key_of(val);
+    const std::uint16_t low = low_of(val);
+
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), key,
+                               [](const Chunk& c, std::uint16_t k) { return c.key < k; });
+    if (it == chunks.end() || it->key != key) {
+        chunks.insert(it, Chunk{key, ChunkOps::array, 1, 1, {low}, {}});
+        ++counter;
+        return;
+    }
+    if (ChunkOps::contains(*it, low)) return;
+
+    ChunkOps::add(*it, low);
+    ++counter;
+}
+
+/*
+ * Remove val, if it belongs to the set
+ */
+void BitmapSet::erase(int val) {
+    const std::uint16_t key = key_of(val);
+    const std::uint16_t low = low_of(val);
+
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), key,
+                               [](const Chunk& c, std::uint16_t k) { return c.key < k; });
+    if (it == chunks.end() || it->key != key || !ChunkOps::contains(*it, low)) return;
+
+    ChunkOps::remove(*it, low);
+    --counter;
+
+    if (it->card == 0) chunks.erase(it);
+}
+
+/*
+ * Test whether val belongs to the BitmapSet
+ */
+bool BitmapSet::is_member(int val) const {
+    const std::uint16_t key = key_of(val);
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), key,
+                               [](const Chunk& c, std::uint16_t k) { return c.key < k; });
+    return it != chunks.end() && it->key == key && ChunkOps::contains(*it, low_of(val));
+}
+
+/*
+ * Number of bytes used by the BitmapSet, including its containers
+ */
+size_t BitmapSet::size_in_bytes() const {
+    size_t bytes = sizeof(*this) + chunks.capacity() * sizeof(Chunk);
+    for (const Chunk& c : chunks) {
+        bytes += c.data.capacity() * sizeof(std::uint16_t) + c.words.capacity() * sizeof(std::uint64_t);
+    }
+    return bytes;
+}
+
+/*
+ * Test whether *this and S represent the same set
+ */
+bool BitmapSet::operator==(const BitmapSet& S) const {
+    if (counter != S.counter || chunks.size() != S.chunks.size()) return false;
+    for (std::size_t i = 0; i < chunks.size(); ++i) {
+        if (chunks[i].key != S.chunks[i].key || !ChunkOps::equal(chunks[i], S.chunks[i])) return false;
+    }
+    return true;
+}
+
+/*
+ * Three-way comparison operator: set inclusion
+ * Each chunk of the smallest set is looked up, by key, in the other set and tested for inclusion,
+ * without building any chunk, until one is not included
+ */
+std::partial_ordering BitmapSet::operator<=>(const BitmapSet& S) const {
+    if (counter == S.counter) {
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+
+    const bool shorter = (counter < S.counter);
+    const std::vector<Chunk>& c_short = shorter ? chunks : S.chunks;
+    const std::vector<Chunk>& c_long = shorter ? S.chunks : chunks;
+    if (c_short.size() > c_long.size()) return std::partial_ordering::unordered;
+
+    auto it = c_long.begin();
+    for (const Chunk& c : c_short) {
+        it = std::lower_bound(it, c_long.end(), c.key, [](const Chunk& x, std::uint16_t k) { return x.key < k; });
+        if (it == c_long.end() || it->key != c.key || !ChunkOps::includes(*it, c)) {
+            return std::partial_ordering::unordered;
+        }
+    }
+    return shorter ? std::partial_ordering::less : std::partial_ordering::greater;
+}
+
+/*
+ * Modify *this such that it becomes the union of *this with S
+ * Chunks with the same key are merged, the other chunks of S are copied
+ */
+BitmapSet& BitmapSet::operator+=(const BitmapSet& S) {
+    std::vector<Chunk> result;
+    result.reserve(chunks.size() + S.chunks.size());
+
+    std::size_t i = 0, j = 0;
+    while (i < chunks.size() || j < S.chunks.size()) {
+        if (j == S.chunks.size() || (i < chunks.size() && chunks[i].key < S.chunks[j].key)) {
+            result.push_back(std::move(chunks[i++]));
+        } else if (i == chunks.size() || S.chunks[j].key < chunks[i].key) {
+            result.push_back(S.chunks[j++]);
+        } else {
+            ChunkOps::unite(chunks[i], S.chunks[j++]);
+            result.push_back(std::move(chunks[i++]));
+        }
+    }
+
+    chunks = std::move(result);
+    counter = 0;
+    for (const Chunk& c : chunks) counter += c.card;
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the intersection of *this with S
+ * Only chunks with the same key are kept
+ */
+BitmapSet& BitmapSet::operator*=(const BitmapSet& S) {
+    std::vector<Chunk> result;
+
+    std::size_t i = 0, j = 0;
+    while (i < chunks.size() && j < S.chunks.size()) {
+        if (chunks[i].key < S.chunks[j].key) {
+            ++i;
+        } else if (S.chunks[j].key < chunks[i].key) {
+            ++j;
+        } else {
+            ChunkOps::intersect(chunks[i], S.chunks[j++]);
+            if (chunks[i].card > 0) result.push_back(std::move(chunks[i]));
+            ++i;
+        }
+    }
+
+    chunks = std::move(result);
+    counter = 0;
+    for (const Chunk& c : chunks) counter += c.card;
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the difference between *this and S
+ */
+BitmapSet& BitmapSet::operator-=(const BitmapSet& S) {
+    std::vector<Chunk> result;
+    result.reserve(chunks.size());
+
+    std::size_t j = 0;
+    for (Chunk& c : chunks) {
+        while (j < S.chunks.size() && S.chunks[j].key < c.key) ++j;
+        if (j < S.chunks.size() && S.chunks[j].key == c.key) {
+            ChunkOps::subtract(c, S.chunks[j]);
+        }
+        if (c.card > 0) result.push_back(std::move(c));
+    }
+
+    chunks = std::move(result);
+    counter = 0;
+    for (const Chunk& c : chunks) counter += c.card;
+    return *this;
+}
+
+/*
+ * Write BitmapSet *this to stream os
+ */
+void BitmapSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (const Chunk& c : chunks) {
+            ChunkOps::for_each(c, [&](std::uint16_t low) { os << to_int(c.key, low) << " "; });
+        }
+        os << "}";
+    }
+}
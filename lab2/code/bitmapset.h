@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+
+#include "set.h"
+
+/** Class to represent a Set of ints as a compressed bitmap (Roaring bitmap)
+ *
+ * The 32 bits of a value are split into a 16-bit key (high bits) and a 16-bit low part
+ * All values with the same key are stored in one container, the containers are sorted by key
+ * A container is either
+ *   an array:  sorted low parts, used for at most 4096 values (2 bytes per value)
+ *   a bitmap:  2^16 bits, i.e. 1024 64-bit words (8 KB)
+ *   a run:     sorted intervals [start, start + length] of low parts (4 bytes per interval)
+ * After each operation, a container uses the smallest representation for its values
+ * insert and erase update the number of runs of a container from the neighbours of the value, without a scan,
+ * and convert the container only when another representation becomes smaller
+ *
+ * Set operations are done container by container, with word-level AND, OR and ANDNOT for bitmaps
+ * Conversions from and to class Set are provided
+ */
+class BitmapSet {
+public:
+    /*
+     *  Default constructor :create an empty BitmapSet
+     */
+    BitmapSet() = default;
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    BitmapSet(int val);
+
+    /*
+     * Constructor to create a BitmapSet from a sorted vector of ints
+     */
+    explicit BitmapSet(const std::vector<int>& list_of_values);
+
+    /*
+     * Constructor to create a BitmapSet with the same elements as Set S
+     */
+    explicit BitmapSet(const Set& S);
+
+    /*
+     * Return a Set with the same elements as the BitmapSet
+     */
+    Set to_set() const;
+
+    /*
+     * Return a sorted vector with all ints in the BitmapSet
+     */
+    std::vector<int> to_vector() const;
+
+    /*
+     * Transform the BitmapSet into an empty set
+     */
+    void make_empty();
+
+    /*
+     * Insert val, if it does not belong to the set yet
+     */
+    void insert(int val);
+
+    /*
+     * Remove val, if it belongs to the set
+     */
+    void erase(int val);
+
+    /*
+     * Test whether val belongs to the BitmapSet
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Test whether the BitmapSet is empty
+     */
+    bool is_empty() const {
+        return (counter == 0);
+    }
+
+    /*
+     * Count the number of values stored in the BitmapSet
+     */
+    size_t cardinality() const {
+        return counter;
+    }
+
+    /*
+     * Number of bytes used by the BitmapSet, including its containers
+     */
+    size_t size_in_bytes() const;
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const BitmapSet& S) const;
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const BitmapSet& S) const;
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     */
+    BitmapSet& operator+=(const BitmapSet& S);
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     */
+    BitmapSet& operator*=(const BitmapSet& S);
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     */
+    BitmapSet& operator-=(const BitmapSet& S);
+
+private:
+    // Container of the values with the same key
+    struct Chunk {
+        std::uint16_t key{0};
+        std::uint8_t kind{0};               // array, bitmap or run, see class ChunkOps
+        std::uint32_t card{0};              // number of values in the container
+        std::uint32_t runs{0};              // number of runs of consecutive values, to choose the representation
+        std::vector<std::uint16_t> data{};  // array: low parts, run: pairs (start, length)
+        std::vector<std::uint64_t> words{}; // bitmap: 1024 words
+    };
+
+    class ChunkOps;  // algorithms on containers, defined in bitmapset.cpp
+
+    std::vector<Chunk> chunks;  // sorted by key, no chunk is empty
+    size_t counter{0};          // number of values in the set
+
+    /*
+     * Write BitmapSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const BitmapSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    friend BitmapSet operator+(BitmapSet S1, const BitmapSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend BitmapSet operator*(BitmapSet S1, const BitmapSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend BitmapSet operator-(BitmapSet S1, const BitmapSet& S2) {
+        return (S1 -= S2);
+    }
+};
@@ -0,0 +1,119 @@
+#include "bufferedset.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * Transform the BufferedSet into an empty set
+ */
+void BufferedSet::make_empty() {
+    set.make_empty();
+    buffer.clear();
+}
+
+/*
+ * Add val to the write buffer, and merge the buffer if it is full
+ */
+void BufferedSet::insert(int val) {
+    buffer.push_back(val);
+    flush_if_full();
+}
+
+/*
+ * Remove val from the BufferedSet, after merging the buffer
+ * Return false, if val does not belong to the BufferedSet
+ */
+bool BufferedSet::erase(int val) {
+    flush();
+    return (set.erase(val) == 1);
+}
+
+/*
+ * Merge the write buffer into the Set
+ * A buffer of b values, small against the n values of the Set, is inserted value by value through the express lanes,
+ * in O(b log n) time, the lanes following the insertions (see Set::enable_index)
+ * Otherwise, the sorted values are inserted right before the first larger value of the list, found by one walk,
+ * and the lanes are rebuilt by the next lookup, in O(n + b) time
+ */
+void BufferedSet::flush() const {
+    set.enable_index();  // copies and assigned Sets have no express lanes
+    if (buffer.empty())
+        return;
+
+    std::sort(buffer.begin(), buffer.end());
+    buffer.erase(std::unique(buffer.begin(), buffer.end()), buffer.end());
+
+    if (buffer.size() * std::bit_width(set.cardinality()) < set.cardinality()) {
+        for (int val : buffer) {
+            set.insert(val);
+        }
+    } else {
+        Set::const_iterator it = set.begin();
+        for (int val : buffer) {
+            while (it != set.end() && *it < val) {
+                ++it;
+            }
+            if (it == set.end() || *it != val) {
+                it = set.insert(it, val);
+            }
+        }
+        set.disable_index();  // many gaps of the lanes were filled
+        set.enable_index();
+    }
+    buffer.clear();
+}
+
+/*
+ * Modify *this such that it becomes the union of *this with S
+ * A small S (e.g. a singleton) is appended to the write buffer, otherwise the Sets are merged
+ */
+BufferedSet& BufferedSet::operator+=(const BufferedSet& S) {
+    if (&S == this)
+        return *this;
+
+    if (S.set.cardinality() + S.buffer.size() <= min_capacity) {
+        buffer.insert(buffer.end(), S.buffer.begin(), S.buffer.end());
+        buffer.insert(buffer.end(), S.set.begin(), S.set.end());
+        flush_if_full();
+    } else {
+        flush();
+        set += S.view();
+    }
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the intersection of *this with S
+ */
+BufferedSet& BufferedSet::operator*=(const BufferedSet& S) {
+    flush();
+    set *= S.view();
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the difference between *this and S
+ */
+BufferedSet& BufferedSet::operator-=(const BufferedSet& S) {
+    flush();
+    set -= S.view();
+    return *this;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Merge the buffer, if it holds more than max(min_capacity, cardinality / 4) values
+ */
+void BufferedSet::flush_if_full() {
+    if (buffer.size() > std::max(min_capacity, set.cardinality() / 4)) {
+        flush();
+    }
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+
+#include "set.h"
+
+/** Class to represent a Set of ints with a write buffer, for bursts of insertions
+ *
+ * A BufferedSet is a Set and an unsorted buffer of inserted values, possibly with repetitions
+ * insert appends val to the buffer in O(1) time, instead of walking the list
+ * The buffer is merged into the Set when it holds more than max(min_capacity, cardinality / 4) values,
+ * or when an operation needs the values in order: lookups, comparisons, *=, -=, printing, ...
+ *
+ * The Set has express lanes (see Set::enable_index), so that lookups take O(log n) time
+ * Merging sorts the b buffered values, then inserts them one by one through the lanes, in O(b log n) time,
+ * or in one walk through the list, in O(n + b) time, when b is not much smaller than n: the lanes are then rebuilt
+ * Thus, an insertion of random or increasing keys takes O(log n) amortized time, however often the BufferedSet is read
+ *
+ * Const functions merge the buffer, as the express lanes of Set are rebuilt on demand:
+ * a BufferedSet must not be read by several threads at the same time
+ */
+class BufferedSet {
+public:
+    static constexpr std::size_t min_capacity = 256;
+
+    /*
+     *  Default constructor :create an empty BufferedSet
+     */
+    BufferedSet() = default;
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    BufferedSet(int val) : set{val} {
+    }
+
+    /*
+     * Constructor to create a BufferedSet from a sorted vector of ints
+     */
+    explicit BufferedSet(const std::vector<int>& list_of_values) : set{list_of_values} {
+    }
+
+    /*
+     * Constructor to create a BufferedSet with the same elements as Set S
+     */
+    explicit BufferedSet(const Set& S) : set{S} {
+    }
+
+    /*
+     * Return the Set with all values of the BufferedSet, after merging the buffer
+     * Its read-only functions (iterators, range, lower_bound, ...) can be used directly
+     */
+    const Set& view() const {
+        flush();
+        return set;
+    }
+
+    /*
+     * Return a Set with the same elements as the BufferedSet
+     */
+    Set to_set() const {
+        return view();
+    }
+
+    /*
+     * Return a sorted vector with all ints in the BufferedSet
+     */
+    std::vector<int> to_vector() const {
+        return view().to_vector();
+    }
+
+    /*
+     * Transform the BufferedSet into an empty set
+     */
+    void make_empty();
+
+    /*
+     * Add val to the write buffer
+     * It takes O(log n) amortized time, the merges of the buffer included
+     */
+    void insert(int val);
+
+    /*
+     * Remove val from the BufferedSet, after merging the buffer
+     * Return false, if val does not belong to the BufferedSet
+     */
+    bool erase(int val);
+
+    /*
+     * Merge the write buffer into the Set
+     */
+    void flush() const;
+
+    /*
+     * Number of values in the write buffer, repetitions included
+     */
+    size_t buffered() const {
+        return buffer.size();
+    }
+
+    bool is_member(int val) const {
+        return view().is_member(val);
+    }
+
+    bool is_empty() const {
+        return (set.is_empty() && buffer.empty());
+    }
+
+    size_t cardinality() const {
+        return view().cardinality();
+    }
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const BufferedSet& S) const {
+        return (view() == S.view());
+    }
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const BufferedSet& S) const {
+        return (view() <=> S.view());
+    }
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     * A small S (e.g. a singleton) is appended to the write buffer, otherwise the Sets are merged
+     */
+    BufferedSet& operator+=(const BufferedSet& S);
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     */
+    BufferedSet& operator*=(const BufferedSet& S);
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     */
+    BufferedSet& operator-=(const BufferedSet& S);
+
+private:
+    mutable Set set;                  // merged values
+    mutable std::vector<int> buffer;  // inserted values, not merged yet
+
+    /*
+     * Merge the buffer, if it holds more than max(min_capacity, cardinality / 4) values
+     */
+    void flush_if_full();
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    friend std::ostream& operator<<(std::ostream& os, const BufferedSet& S) {
+        return (os << S.view());
+    }
+
+    friend BufferedSet operator+(BufferedSet S1, const BufferedSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend BufferedSet operator*(BufferedSet S1, const BufferedSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend BufferedSet operator-(BufferedSet S1, const BufferedSet& S2) {
+        return (S1 -= S2);
+    }
+};
@@ -0,0 +1,322 @@
+#include "compactset.h"
+
+#include <stdexcept>
+#include <utility>
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ *  Default constructor :create an empty CompactSet, with the dummy head and tail slots only
+ */
+CompactSet::CompactSet() : slots{Slot{0, tail, none}, Slot{0, none, head}} {
+}
+
+/*
+ *  Conversion constructor: convert val into a singleton {val}
+ */
+CompactSet::CompactSet(int val) : CompactSet{} {
+    insert_node(head, val);
+}
+
+/*
+ * Constructor to create a CompactSet from a sorted vector of ints
+ * The values are stored in consecutive slots, in increasing order
+ */
+CompactSet::CompactSet(const std::vector<int>& list_of_values) : CompactSet{} {
+    slots.reserve(list_of_values.size() + 2);
+    for (int val : list_of_values) {
+        insert_node(slots[tail].prev, val);
+    }
+}
+
+/*
+ * Constructor to create a CompactSet with the same elements as Set S
+ */
+CompactSet::CompactSet(const Set& S) : CompactSet{S.to_vector()} {
+}
+
+/*
+ * Move constructor: steal the arena of S, S becomes an empty CompactSet
+ */
+CompactSet::CompactSet(CompactSet&& S) : CompactSet{} {
+    std::swap(slots, S.slots);
+    std::swap(free_list, S.free_list);
+    std::swap(counter, S.counter);
+}
+
+/*
+ * Assignment operator, call by value is used
+ */
+CompactSet& CompactSet::operator=(CompactSet S) {
+    std::swap(slots, S.slots);
+    std::swap(free_list, S.free_list);
+    std::swap(counter, S.counter);
+    return *this;
+}
+
+/*
+ * Return a Set with the same elements as the CompactSet
+ */
+Set CompactSet::to_set() const {
+    return Set{to_vector()};
+}
+
+/*
+ * Return a sorted vector with all ints in the CompactSet
+ */
+std::vector<int> CompactSet::to_vector() const {
+    std::vector<int> list_of_values;
+    list_of_values.reserve(counter);
+    for (std::uint32_t p = slots[head].next; p != tail; p = slots[p].next) {
+        list_of_values.push_back(slots[p].value);
+    }
+    return list_of_values;
+}
+
+/*
+ * Transform the CompactSet into an empty set, and release the arena
+ */
+void CompactSet::make_empty() {
+    *this = CompactSet{};
+}
+
+/*
+ * Renumber the slots in the order of the list and release the free slots
+ * The values are copied into a new arena of exactly cardinality() + 2 slots
+ */
+void CompactSet::compact() {
+    CompactSet result;
+    result.slots.reserve(counter + 2);
+    for (std::uint32_t p = slots[head].next; p != tail; p = slots[p].next) {
+        result.insert_node(result.slots[tail].prev, slots[p].value);
+    }
+    *this = std::move(result);
+}
+
+/*
+ * Test whether val belongs to the CompactSet
+ */
+bool CompactSet::is_member(int val) const {
+    std::uint32_t p = slots[head].next;
+    while (p != tail && slots[p].value < val) {
+        p = slots[p].next;
+    }
+    return (p != tail && slots[p].value == val);
+}
+
+/*
+ * Add val to the CompactSet
+ * Return false, if val already belongs to the CompactSet
+ */
+bool CompactSet::insert(int val) {
+    std::uint32_t p = slots[head].next;
+    while (p != tail && slots[p].value < val) {
+        p = slots[p].next;
+    }
+    if (p != tail && slots[p].value == val)
+        return false;
+    insert_node(slots[p].prev, val);
+    return true;
+}
+
+/*
+ * Remove val from the CompactSet
+ * Return false, if val does not belong to the CompactSet
+ */
+bool CompactSet::erase(int val) {
+    std::uint32_t p = slots[head].next;
+    while (p != tail && slots[p].value < val) {
+        p = slots[p].next;
+    }
+    if (p == tail || slots[p].value != val)
+        return false;
+    remove_node(p);
+    return true;
+}
+
+/*
+ * Test whether *this and S represent the same set
+ */
+bool CompactSet::operator==(const CompactSet& S) const {
+    if (counter != S.counter)
+        return false;
+    for (std::uint32_t p = slots[head].next, q = S.slots[head].next; p != tail; p = slots[p].next, q = S.slots[q].next) {
+        if (slots[p].value != S.slots[q].value)
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Three-way comparison operator: set inclusion, as for class Set
+ */
+std::partial_ordering CompactSet::operator<=>(const CompactSet& S) const {
+    if (counter == S.counter) {
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+
+    const bool shorter = (counter < S.counter);
+    const std::vector<Slot>& s_short = shorter ? slots : S.slots;
+    const std::vector<Slot>& s_long = shorter ? S.slots : slots;
+
+    std::uint32_t p_short = s_short[head].next;
+    std::uint32_t p_long = s_long[head].next;
+    while (p_short != tail && p_long != tail) {
+        if (s_short[p_short].value == s_long[p_long].value) {
+            p_short = s_short[p_short].next;
+            p_long = s_long[p_long].next;
+        } else if (s_short[p_short].value < s_long[p_long].value) {
+            return std::partial_ordering::unordered;
+        } else {
+            p_long = s_long[p_long].next;
+        }
+    }
+
+    if (p_short != tail)
+        return std::partial_ordering::unordered;
+    return shorter ? std::partial_ordering::less : std::partial_ordering::greater;
+}
+
+/*
+ * Modify *this such that it becomes the union of *this with S
+ * The values of S are inserted in *this while both lists are walked, as in Set::operator+=
+ */
+CompactSet& CompactSet::operator+=(const CompactSet& S) {
+    std::uint32_t p_this = slots[head].next;
+    std::uint32_t p_other = S.slots[head].next;
+
+    while (p_this != tail && p_other != tail) {
+        if (slots[p_this].value == S.slots[p_other].value) {
+            p_this = slots[p_this].next;
+            p_other = S.slots[p_other].next;
+        } else if (S.slots[p_other].value < slots[p_this].value) {
+            insert_node(slots[p_this].prev, S.slots[p_other].value);
+            p_other = S.slots[p_other].next;
+        } else {
+            p_this = slots[p_this].next;
+        }
+    }
+    while (p_other != tail) {
+        insert_node(slots[tail].prev, S.slots[p_other].value);
+        p_other = S.slots[p_other].next;
+    }
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the intersection of *this with S
+ * The slots of the removed values are freed, and the arena compacted if more than half of it is free
+ */
+CompactSet& CompactSet::operator*=(const CompactSet& S) {
+    std::uint32_t p_this = slots[head].next;
+    std::uint32_t p_other = S.slots[head].next;
+
+    while (p_this != tail && p_other != tail) {
+        if (slots[p_this].value == S.slots[p_other].value) {
+            p_this = slots[p_this].next;
+            p_other = S.slots[p_other].next;
+        } else if (slots[p_this].value < S.slots[p_other].value) {
+            p_this = slots[p_this].next;
+            remove_node(slots[p_this].prev);
+        } else {
+            p_other = S.slots[p_other].next;
+        }
+    }
+    while (p_this != tail) {
+        p_this = slots[p_this].next;
+        remove_node(slots[p_this].prev);
+    }
+
+    shrink();
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the difference between *this and S
+ * The slots of the removed values are freed, and the arena compacted if more than half of it is free
+ */
+CompactSet& CompactSet::operator-=(const CompactSet& S) {
+    std::uint32_t p_this = slots[head].next;
+    std::uint32_t p_other = S.slots[head].next;
+
+    while (p_this != tail && p_other != tail) {
+        if (slots[p_this].value == S.slots[p_other].value) {
+            p_this = slots[p_this].next;
+            p_other = S.slots[p_other].next;
+            remove_node(slots[p_this].prev);
+        } else if (slots[p_this].value < S.slots[p_other].value) {
+            p_this = slots[p_this].next;
+        } else {
+            p_other = S.slots[p_other].next;
+        }
+    }
+
+    shrink();
+    return *this;
+}
+
+/*
+ * Write CompactSet *this to stream os, in the same format as a Set
+ */
+void CompactSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (std::uint32_t p = slots[head].next; p != tail; p = slots[p].next) {
+            os << slots[p].value << " ";
+        }
+        os << "}";
+    }
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Insert a new slot storing val after slot p
+ * The first free slot is reused, otherwise a slot is appended to the arena
+ * Throw std::length_error, if all 32-bit indices are used, as std::vector does beyond its max_size
+ */
+void CompactSet::insert_node(std::uint32_t p, int val) {
+    static_assert(sizeof(Slot) == 12, "a slot is an int and two 32-bit indices");
+
+    std::uint32_t q = free_list;
+    if (q != none) {
+        free_list = slots[q].next;
+    } else {
+        if (slots.size() == none)
+            throw std::length_error{"CompactSet: more than 2^32 - 3 values"};
+        q = static_cast<std::uint32_t>(slots.size());
+        slots.emplace_back();
+    }
+
+    const std::uint32_t n = slots[p].next;
+    slots[q] = Slot{val, n, p};
+    slots[n].prev = q;
+    slots[p].next = q;
+    ++counter;
+}
+
+/*
+ * Remove slot p from the list and add it to the free list
+ */
+void CompactSet::remove_node(std::uint32_t p) {
+    slots[slots[p].prev].next = slots[p].next;
+    slots[slots[p].next].prev = slots[p].prev;
+    slots[p].next = free_list;
+    free_list = p;
+    --counter;
+}
+
+/*
+ * Compact the arena, if more than half of its slots are free
+ */
+void CompactSet::shrink() {
+    if (slots.size() - 2 - counter > counter) {
+        compact();
+    }
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+
+#include "set.h"
+
+/** Class to represent a Set of ints as a doubly linked list stored in an arena
+ *
+ * CompactSet is the sorted doubly linked list of class Set, with dummy head and tail nodes,
+ * but its nodes are slots of one contiguous array and the links are 32-bit indices into that array
+ * A slot takes 12 bytes, instead of 24 bytes plus the allocator overhead for a Node of class Set
+ *
+ * Slots of removed values are chained in a free list, through their next index, and reused by the next insertions
+ * make_empty releases the arena, and compact() renumbers the slots in the order of the list, dropping the free ones,
+ * which *= and -= call when more than half of the slots are free
+ *
+ * It has the same interface as class Set and the same linear-time algorithms
+ * A CompactSet stores at most 2^32 - 3 values: further insertions throw std::length_error, leaving it unchanged
+ */
+class CompactSet {
+public:
+    /*
+     *  Default constructor :create an empty CompactSet
+     */
+    CompactSet();
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    CompactSet(int val);
+
+    /*
+     * Constructor to create a CompactSet from a sorted vector of ints
+     */
+    explicit CompactSet(const std::vector<int>& list_of_values);
+
+    /*
+     * Constructor to create a CompactSet with the same elements as Set S
+     */
+    explicit CompactSet(const Set& S);
+
+    /*
+     * Copy constructor: create a new CompactSet as a copy of S, the free slots included
+     */
+    CompactSet(const CompactSet& S) = default;
+
+    /*
+     * Move constructor: steal the arena of S, S becomes an empty CompactSet
+     */
+    CompactSet(CompactSet&& S);
+
+    /*
+     * Assignment operator, call by value is used
+     */
+    CompactSet& operator=(CompactSet S);
+
+    /*
+     * Return a Set with the same elements as the CompactSet
+     */
+    Set to_set() const;
+
+    /*
+     * Return a sorted vector with all ints in the CompactSet
+     */
+    std::vector<int> to_vector() const;
+
+    /*
+     * Transform the CompactSet into an empty set, and release the arena
+     */
+    void make_empty();
+
+    /*
+     * Renumber the slots in the order of the list and release the free slots
+     */
+    void compact();
+
+    /*
+     * Test whether val belongs to the CompactSet
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Add val to the CompactSet
+     * Return false, if val already belongs to the CompactSet
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val from the CompactSet
+     * Return false, if val does not belong to the CompactSet
+     */
+    bool erase(int val);
+
+    bool is_empty() const {
+        return (counter == 0);
+    }
+
+    size_t cardinality() const {
+        return counter;
+    }
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const CompactSet& S) const;
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const CompactSet& S) const;
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     */
+    CompactSet& operator+=(const CompactSet& S);
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     */
+    CompactSet& operator*=(const CompactSet& S);
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     */
+    CompactSet& operator-=(const CompactSet& S);
+
+    /*
+     * Return number of slots in the arena, including dummy and free slots
+     * Used solely for debug purposes
+     */
+    size_t get_count_slots() const {
+        return slots.size();
+    }
+
+private:
+    /*
+     * A node of the list, or a free slot
+     */
+    struct Slot {
+        int value;
+        std::uint32_t next;  // index of the next slot, or of the next free slot
+        std::uint32_t prev;  // index of the previous slot
+    };
+
+    static constexpr std::uint32_t head = 0;  // index of the dummy header slot
+    static constexpr std::uint32_t tail = 1;  // index of the dummy tail slot
+    static constexpr std::uint32_t none = UINT32_MAX;
+
+    std::vector<Slot> slots;
+    std::uint32_t free_list{none};  // first free slot
+    size_t counter{0};              // number of values in the CompactSet
+
+    /*
+     * Insert a new slot storing val after slot p
+     * Throw std::length_error, if the arena has no index left
+     */
+    void insert_node(std::uint32_t p, int val);
+
+    /*
+     * Remove slot p from the list and add it to the free list
+     */
+    void remove_node(std::uint32_t p);
+
+    /*
+     * Compact the arena, if more than half of its slots are free
+     */
+    void shrink();
+
+    /*
+     * Write CompactSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    friend std::ostream& operator<<(std::ostream& os, const CompactSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    friend CompactSet operator+(CompactSet S1, const CompactSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend CompactSet operator*(CompactSet S1, const CompactSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend CompactSet operator-(CompactSet S1, const CompactSet& S2) {
+        return (S1 -= S2);
+    }
+};
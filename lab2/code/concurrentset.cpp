@@ -0,0 +1,282 @@
+#include "concurrentset.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <thread>
+
+/*****************************************************
+ * Epoch-based reclamation                            *
+ ******************************************************/
+
+/*
+ * A global epoch counter is shared by all ConcurrentSets
+ * Each thread owns one slot: while it walks a list, the slot stores the epoch read when the walk started,
+ * otherwise the slot is idle
+ * A removed node is retired with the epoch read after it was unlinked
+ * Then it can be deleted as soon as every busy slot stores a larger epoch:
+ * those walks started after the node was unlinked, and the other threads are not walking any list
+ */
+namespace {
+
+constexpr std::size_t max_threads = 256;
+constexpr std::uint64_t idle = std::numeric_limits<std::uint64_t>::max();
+
+struct alignas(64) Slot {  // one cache line per slot, to avoid false sharing between threads
+    std::atomic<std::uint64_t> epoch{idle};
+    std::atomic<bool> in_use{false};
+};
+
+std::atomic<std::uint64_t> global_epoch{0};
+std::array<Slot, max_threads> slots;
+
+/*
+ * Slot of the calling thread, claimed at its first walk and released when the thread ends
+ */
+class ThreadSlot {
+public:
+    ThreadSlot() {
+        while (true) {
+            for (Slot& s : slots) {
+                bool expected = false;
+                if (s.in_use.compare_exchange_strong(expected, true)) {
+                    slot = &s;
+                    return;
+                }
+            }
+            std::this_thread::yield();  // more than max_threads threads: wait until one ends
+        }
+    }
+
+    ~ThreadSlot() {
+        slot->in_use.store(false);
+    }
+
+    Slot* slot;
+};
+
+/*
+ * Guard for a walk of a list: the nodes reached during the lifetime of the guard are not deleted
+ */
+class EpochGuard {
+public:
+    EpochGuard() : slot{this_thread_slot().slot} {
+        slot->epoch.store(global_epoch.load());
+    }
+
+    ~EpochGuard() {
+        slot->epoch.store(idle);
+    }
+
+private:
+    Slot* slot;
+
+    static ThreadSlot& this_thread_slot() {
+        thread_local ThreadSlot ts;
+        return ts;
+    }
+};
+
+/*
+ * Smallest epoch stored by a busy slot (idle, if there is none)
+ */
+std::uint64_t oldest_epoch() {
+    std::uint64_t oldest = idle;
+    for (const Slot& s : slots) {
+        oldest = std::min(oldest, s.epoch.load());
+    }
+    return oldest;
+}
+
+}  // namespace
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ *  Default constructor :create an empty ConcurrentSet
+ */
+ConcurrentSet::ConcurrentSet() : head{new Node()}, tail{new Node()} {
+    head->next.store(tail);
+}
+
+/*
+ * Constructor to create a ConcurrentSet from a sorted vector of ints
+ */
+ConcurrentSet::ConcurrentSet(const std::vector<int>& list_of_values) : ConcurrentSet{} {
+    Node* ptr = head;
+    for (int val : list_of_values) {
+        Node* p = new Node(val, tail);
+        ptr->next.store(p);
+        ptr = p;
+    }
+    counter.store(list_of_values.size());
+}
+
+/*
+ * Constructor to create a ConcurrentSet with the same elements as Set S
+ */
+ConcurrentSet::ConcurrentSet(const Set& S) : ConcurrentSet{S.to_vector()} {
+}
+
+/*
+ * Destructor: deallocate all nodes, including the retired ones
+ */
+ConcurrentSet::~ConcurrentSet() {
+    Node* ptr = head;
+    while (ptr != nullptr) {
+        Node* p = ptr;
+        ptr = ptr->next.load();
+        delete p;
+    }
+    for (auto [p, epoch] : retired) {
+        delete p;
+    }
+}
+
+/*
+ * Return a Set with the same elements as the ConcurrentSet
+ */
+Set ConcurrentSet::to_set() const {
+    return Set{to_vector()};
+}
+
+/*
+ * Return a sorted vector with all ints in the ConcurrentSet
+ * Values inserted or erased by other threads during the walk may or may not be included
+ */
+std::vector<int> ConcurrentSet::to_vector() const {
+    EpochGuard guard;
+    std::vector<int> list_of_values;
+    list_of_values.reserve(counter.load());
+    for (Node* ptr = head->next.load(); ptr != tail; ptr = ptr->next.load()) {
+        list_of_values.push_back(ptr->value);
+    }
+    return list_of_values;
+}
+
+/*
+ * Test whether val belongs to the ConcurrentSet
+ * A node that is being removed does not count
+ */
+bool ConcurrentSet::is_member(int val) const {
+    EpochGuard guard;
+    Node* curr = locate(val).second;
+    return (curr != tail && curr->value == val && !curr->removed.load());
+}
+
+/*
+ * Add val to the ConcurrentSet
+ * Return false, if val already belongs to the ConcurrentSet
+ */
+bool ConcurrentSet::insert(int val) {
+    EpochGuard guard;
+    while (true) {
+        auto [pred, curr] = locate(val);
+        std::scoped_lock locks{pred->lock, curr->lock};
+        if (!validate(pred, curr))
+            continue;  // another thread modified pred or curr: start again
+        if (curr != tail && curr->value == val)
+            return false;
+        pred->next.store(new Node(val, curr));
+        ++counter;
+        return true;
+    }
+}
+
+/*
+ * Remove val from the ConcurrentSet
+ * Return false, if val does not belong to the ConcurrentSet
+ */
+bool ConcurrentSet::erase(int val) {
+    Node* victim = nullptr;
+    {
+        EpochGuard guard;
+        while (true) {
+            auto [pred, curr] = locate(val);
+            std::scoped_lock locks{pred->lock, curr->lock};
+            if (!validate(pred, curr))
+                continue;
+            if (curr == tail || curr->value != val)
+                return false;
+            curr->removed.store(true);  // logical removal: is_member does not see val anymore
+            pred->next.store(curr->next.load());
+            --counter;
+            victim = curr;
+            break;
+        }
+    }
+    retire(victim);
+    return true;
+}
+
+/*
+ * Write ConcurrentSet *this to stream os, in the same format as a Set
+ */
+void ConcurrentSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        EpochGuard guard;
+        os << "{ ";
+        for (Node* ptr = head->next.load(); ptr != tail; ptr = ptr->next.load()) {
+            os << ptr->value << " ";
+        }
+        os << "}";
+    }
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Return the last Node storing a value smaller than val (or head) and the Node after it
+ * The caller must hold an EpochGuard
+ */
+std::pair<ConcurrentSet::Node*, ConcurrentSet::Node*> ConcurrentSet::locate(int val) const {
+    Node* pred = head;
+    Node* curr = head->next.load();
+    while (curr != tail && curr->value < val) {
+        pred = curr;
+        curr = curr->next.load();
+    }
+    return {pred, curr};
+}
+
+/*
+ * Test whether pred and curr, both locked, are still in the list and adjacent
+ */
+bool ConcurrentSet::validate(Node* pred, Node* curr) {
+    return !pred->removed.load() && !curr->removed.load() && pred->next.load() == curr;
+}
+
+/*
+ * Retire a removed node and delete the retired nodes that no thread can reach anymore
+ * Deletion is attempted every reclaim_period retirements, then the global epoch is advanced
+ */
+void ConcurrentSet::retire(Node* p) {
+    constexpr std::size_t reclaim_period = 64;
+
+    std::vector<Node*> unreachable;
+    {
+        std::scoped_lock lock{retired_lock};
+        retired.emplace_back(p, global_epoch.load());
+        if (retired.size() % reclaim_period != 0)
+            return;
+
+        const std::uint64_t oldest = oldest_epoch();
+        auto reachable = std::partition(retired.begin(), retired.end(), [oldest](const auto& r) {
+            return r.second >= oldest;
+        });
+        for (auto it = reachable; it != retired.end(); ++it) {
+            unreachable.push_back(it->first);
+        }
+        retired.erase(reachable, retired.end());
+        global_epoch.fetch_add(1);
+    }
+    for (Node* q : unreachable) {
+        delete q;
+    }
+}
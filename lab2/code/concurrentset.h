@@ -0,0 +1,164 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "set.h"
+
+/** Class to represent a Set of ints shared by several threads
+ *
+ * ConcurrentSet is implemented as a sorted linked list with dummy head and tail nodes, as class Set,
+ * synchronized as a lazy list:
+ *   is_member never locks nor retries: it walks the list and checks that the node found is not removed
+ *   insert and erase walk the list without locking, then lock the two nodes to be modified
+ *   and check that they are still adjacent and not removed, otherwise they start again
+ *   erase marks the node as removed before unlinking it
+ *
+ * A removed node may still be visited by threads walking the list, so it is not deleted right away
+ * It is retired and deleted later by epoch-based reclamation, once no thread can reach it (see concurrentset.cpp)
+ *
+ * All functions, except constructors and the destructor, can be called simultaneously by any number of threads
+ * to_set, to_vector and operator<< are not atomic snapshots, if other threads insert or erase values meanwhile
+ * is_member, insert and erase have a linear time complexity, in the worst case
+ */
+class ConcurrentSet {
+public:
+    /*
+     *  Default constructor :create an empty ConcurrentSet
+     */
+    ConcurrentSet();
+
+    /*
+     * Constructor to create a ConcurrentSet from a sorted vector of ints
+     */
+    explicit ConcurrentSet(const std::vector<int>& list_of_values);
+
+    /*
+     * Constructor to create a ConcurrentSet with the same elements as Set S
+     */
+    explicit ConcurrentSet(const Set& S);
+
+    ConcurrentSet(const ConcurrentSet&) = delete;
+    ConcurrentSet& operator=(const ConcurrentSet&) = delete;
+
+    /*
+     * Destructor: deallocate all nodes, including the retired ones
+     */
+    ~ConcurrentSet();
+
+    /*
+     * Return a Set with the same elements as the ConcurrentSet
+     */
+    Set to_set() const;
+
+    /*
+     * Return a sorted vector with all ints in the ConcurrentSet
+     */
+    std::vector<int> to_vector() const;
+
+    /*
+     * Test whether val belongs to the ConcurrentSet (wait-free)
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Add val to the ConcurrentSet
+     * Return false, if val already belongs to the ConcurrentSet
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val from the ConcurrentSet
+     * Return false, if val does not belong to the ConcurrentSet
+     */
+    bool erase(int val);
+
+    /*
+     * Test whether the ConcurrentSet is empty
+     */
+    bool is_empty() const {
+        return (cardinality() == 0);
+    }
+
+    /*
+     * Count the number of values stored in the ConcurrentSet
+     */
+    size_t cardinality() const {
+        return counter.load();
+    }
+
+private:
+    /*
+     * Lock of a node: it is held only while linking or unlinking a node,
+     * so a one byte lock that yields while waiting keeps the nodes small (a std::mutex takes 40 bytes)
+     */
+    class SpinLock {
+    public:
+        void lock() {
+            while (locked.exchange(true, std::memory_order_acquire)) {
+                while (locked.load(std::memory_order_relaxed)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        bool try_lock() {
+            return !locked.exchange(true, std::memory_order_acquire);
+        }
+
+        void unlock() {
+            locked.store(false, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<bool> locked{false};
+    };
+
+    struct Node {
+        int value;
+        std::atomic<bool> removed{false};  // set by erase before the node is unlinked
+        SpinLock lock;
+        std::atomic<Node*> next;
+
+        Node(int val = 0, Node* nxt = nullptr) : value{val}, next{nxt} {
+        }
+    };
+
+    Node* head;  // pointer to the dummy header Node
+    Node* tail;  // pointer to the dummy tail Node
+    std::atomic<size_t> counter{0};
+
+    // Removed nodes, with the epoch when they were retired
+    std::mutex retired_lock;
+    std::vector<std::pair<Node*, std::uint64_t>> retired;
+
+    /*
+     * Return the last Node storing a value smaller than val (or head) and the Node after it
+     */
+    std::pair<Node*, Node*> locate(int val) const;
+
+    /*
+     * Test whether pred and curr, both locked, are still in the list and adjacent
+     */
+    static bool validate(Node* pred, Node* curr);
+
+    /*
+     * Retire a removed node and delete the retired nodes that no thread can reach anymore
+     */
+    void retire(Node* p);
+
+    /*
+     * Write ConcurrentSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    friend std::ostream& operator<<(std::ostream& os, const ConcurrentSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+};
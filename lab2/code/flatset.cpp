@@ -0,0 +1,231 @@
+#include "flatset.h"
+#include "setkernels.h"
+#include "parallelsort.h"
+
+#include <algorithm>
+#include <thread>
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ *  Conversion constructor: convert val into a singleton {val}
+ */
+FlatSet::FlatSet(int val) : values{val} {
+}
+
+/*
+ * Constructor to create a FlatSet from a sorted vector of ints
+ */
+FlatSet::FlatSet(std::vector<int> list_of_values) : values{std::move(list_of_values)} {
+}
+
+/*
+ * Create a FlatSet from unsorted ints, possibly with repetitions
+ */
+FlatSet FlatSet::from_unsorted(std::vector<int> values) {
+    parallel_sort_unique(values);
+    return FlatSet{std::move(values)};
+}
+
+/*
+ * Constructor to create a FlatSet with the same elements as Set S
+ */
+FlatSet::FlatSet(const Set& S) : values{S.to_vector()} {
+}
+
+/*
+ * Return a Set with the same elements as the FlatSet
+ */
+Set FlatSet::to_set() const {
+    return Set{values};
+}
+
+/*
+ * Test whether val belongs to the FlatSet: binary search
+ */
+bool FlatSet::is_member(int val) const {
+    return std::binary_search(values.begin(), values.end(), val);
+}
+
+/*
+ * Return a view of the values in [lo, hi]: two binary searches
+ */
+std::span<const int> FlatSet::range(int lo, int hi) const {
+    if (hi < lo)
+        return {};
+    const auto first = std::lower_bound(values.begin(), values.end(), lo);
+    const auto last = std::upper_bound(first, values.end(), hi);
+    return {first, last};
+}
+
+/*
+ * Three-way comparison operator: set inclusion
+ */
+std::partial_ordering FlatSet::operator<=>(const FlatSet& S) const {
+    if (cardinality() == S.cardinality()) {
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+    if (cardinality() < S.cardinality()) {
+        return std::includes(S.values.begin(), S.values.end(), values.begin(), values.end())
+                   ? std::partial_ordering::less
+                   : std::partial_ordering::unordered;
+    }
+    return std::includes(values.begin(), values.end(), S.values.begin(), S.values.end())
+               ? std::partial_ordering::greater
+               : std::partial_ordering::unordered;
+}
+
+/*
+ * Modify *this such that it becomes the union of *this with S
+ */
+FlatSet& FlatSet::operator+=(const FlatSet& S) {
+    std::vector<int> result(values.size() + S.values.size() + setkernels::padding);
+    result.resize(setkernels::unite(values.data(), values.size(), S.values.data(), S.values.size(),
+                                    result.data()));
+    values.swap(result);
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the intersection of *this with S
+ */
+FlatSet& FlatSet::operator*=(const FlatSet& S) {
+    std::vector<int> result(std::min(values.size(), S.values.size()) + setkernels::padding);
+    result.resize(setkernels::intersect(values.data(), values.size(), S.values.data(), S.values.size(),
+                                        result.data()));
+    values.swap(result);
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the difference between *this and S
+ */
+FlatSet& FlatSet::operator-=(const FlatSet& S) {
+    std::vector<int> result(values.size() + setkernels::padding);
+    result.resize(setkernels::subtract(values.data(), values.size(), S.values.data(), S.values.size(),
+                                       result.data()));
+    values.swap(result);
+    return *this;
+}
+
+/*
+ * Multi-threaded versions of +=, *= and -=
+ */
+FlatSet& FlatSet::unite(const FlatSet& S, unsigned n_threads) {
+    parallel_merge(S, n_threads, setkernels::unite);
+    return *this;
+}
+
+FlatSet& FlatSet::intersect(const FlatSet& S, unsigned n_threads) {
+    parallel_merge(S, n_threads, setkernels::intersect);
+    return *this;
+}
+
+FlatSet& FlatSet::subtract(const FlatSet& S, unsigned n_threads) {
+    parallel_merge(S, n_threads, setkernels::subtract);
+    return *this;
+}
+
+/*
+ * Write FlatSet *this to stream os
+ */
+void FlatSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (int val : values) {
+            os << val << " ";
+        }
+        os << "}";
+    }
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Replace the values by kernel(values, S.values), computed by n_threads threads
+ *
+ * Merge path: segment t of the output starts at diagonal d = t * (na + nb) / n_segments of the merge,
+ * i.e. after i values of a and j = d - i values of b, where i is found by binary search
+ * such that a[i - 1] <= b[j] and b[j - 1] < a[i]
+ * If a[i - 1] == b[j], j is moved past b[j], so that equal values of a and b are in the same segment
+ *
+ * Each segment is merged to its own part of a buffer, with room for the padding of the kernels,
+ * then the parts are copied, in parallel, to their final positions
+ */
+void FlatSet::parallel_merge(const FlatSet& S, unsigned n_threads, Kernel kernel) {
+    constexpr std::size_t min_segment = 1 << 16;  // smaller segments are not worth a thread
+
+    const int* a = values.data();
+    const int* b = S.values.data();
+    const std::size_t na = values.size();
+    const std::size_t nb = S.values.size();
+    if (n_threads == 0) n_threads = default_thread_count();
+    const std::size_t n_segments = std::max<std::size_t>(1, std::min<std::size_t>(n_threads, (na + nb) / min_segment));
+
+    // Segment t merges a[ia[t], ia[t + 1]) and b[ib[t], ib[t + 1])
+    std::vector<std::size_t> ia(n_segments + 1), ib(n_segments + 1);
+    ia[n_segments] = na;
+    ib[n_segments] = nb;
+    for (std::size_t t = 1; t < n_segments; ++t) {
+        const std::size_t d = t * (na + nb) / n_segments;
+        std::size_t lo = (d > nb) ? d - nb : 0;
+        std::size_t hi = std::min(d, na);
+        while (lo < hi) {
+            const std::size_t mid = lo + (hi - lo) / 2;
+            if (a[mid] <= b[d - mid - 1]) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        ia[t] = lo;
+        ib[t] = d - lo;
+        if (ia[t] > 0 && ib[t] < nb && a[ia[t] - 1] == b[ib[t]]) {
+            ++ib[t];
+        }
+    }
+
+    // The output of segment t is written at offset ia[t] + ib[t] + t * padding of buffer
+    std::vector<int> buffer(na + nb + n_segments * setkernels::padding);
+    std::vector<std::size_t> sizes(n_segments);
+    auto merge_segment = [&](std::size_t t) {
+        sizes[t] = kernel(a + ia[t], ia[t + 1] - ia[t], b + ib[t], ib[t + 1] - ib[t],
+                          buffer.data() + ia[t] + ib[t] + t * setkernels::padding);
+    };
+
+    if (n_segments == 1) {
+        merge_segment(0);
+        buffer.resize(sizes[0]);
+        values.swap(buffer);
+        return;
+    }
+
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t = 0; t < n_segments; ++t) {
+            threads.emplace_back(merge_segment, t);
+        }
+    }  // join
+
+    std::vector<std::size_t> offsets(n_segments + 1, 0);
+    for (std::size_t t = 0; t < n_segments; ++t) {
+        offsets[t + 1] = offsets[t] + sizes[t];
+    }
+    std::vector<int> result(offsets[n_segments]);
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t = 0; t < n_segments; ++t) {
+            threads.emplace_back([&, t] {
+                const int* part = buffer.data() + ia[t] + ib[t] + t * setkernels::padding;
+                std::copy(part, part + sizes[t], result.begin() + static_cast<std::ptrdiff_t>(offsets[t]));
+            });
+        }
+    }  // join
+    values.swap(result);
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <cstddef>
+
+#include "set.h"
+
+/** Class to represent a Set of ints in contiguous storage
+ *
+ * FlatSet is implemented as a sorted vector of ints, without repetitions
+ * It has the same interface as class Set
+ * Union, intersection and difference use the vectorized merge kernels in setkernels.h
+ *
+ * All FlatSet operations have a linear time complexity, in the worst case
+ * is_member has a logarithmic time complexity
+ */
+class FlatSet {
+public:
+    /*
+     *  Default constructor :create an empty FlatSet
+     */
+    FlatSet() = default;
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    FlatSet(int val);
+
+    /*
+     * Constructor to create a FlatSet from a sorted vector of ints
+     * Create a FlatSet with all ints in sorted vector list_of_values
+     */
+    explicit FlatSet(std::vector<int> list_of_values);
+
+    /*
+     * Create a FlatSet from unsorted ints, possibly with repetitions
+     * The values are sorted and repetitions removed in parallel (see parallelsort.h)
+     * and the vector is kept as the storage of the FlatSet
+     */
+    static FlatSet from_unsorted(std::vector<int> values);
+
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_value_t<R>, int>
+    static FlatSet from_unsorted(R&& values) {
+        std::vector<int> V;
+        if constexpr (std::ranges::sized_range<R>) {
+            V.reserve(std::ranges::size(values));
+        }
+        std::ranges::copy(values, std::back_inserter(V));
+        return from_unsorted(std::move(V));
+    }
+
+    /*
+     * Constructor to create a FlatSet with the same elements as Set S
+     */
+    explicit FlatSet(const Set& S);
+
+    /*
+     * Return a Set with the same elements as the FlatSet
+     */
+    Set to_set() const;
+
+    /*
+     * Transform the FlatSet into an empty set
+     */
+    void make_empty() {
+        values.clear();
+    }
+
+    /*
+     * Test whether val belongs to the FlatSet
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Return a view of the values in [lo, hi], in increasing order, in O(log n) time
+     * The view points into the FlatSet, and it stays valid until the FlatSet is modified
+     */
+    std::span<const int> range(int lo, int hi) const;
+
+    /*
+     * Count the values in [lo, hi], in O(log n) time
+     */
+    size_t count_range(int lo, int hi) const {
+        return range(lo, hi).size();
+    }
+
+    /*
+     * Test whether the FlatSet is empty
+     */
+    bool is_empty() const {
+        return values.empty();
+    }
+
+    /*
+     * Count the number of values stored in the FlatSet
+     */
+    size_t cardinality() const {
+        return values.size();
+    }
+
+    /*
+     * Sorted values stored in the FlatSet
+     */
+    const std::vector<int>& to_vector() const {
+        return values;
+    }
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const FlatSet& S) const = default;
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const FlatSet& S) const;
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     */
+    FlatSet& operator+=(const FlatSet& S);
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     */
+    FlatSet& operator*=(const FlatSet& S);
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     */
+    FlatSet& operator-=(const FlatSet& S);
+
+    /*
+     * Multi-threaded versions of +=, *= and -=, using n_threads threads (0: one per hardware thread)
+     * Both FlatSets are split into n_threads segments with value-consistent bounds (merge path),
+     * the segments are merged concurrently by the kernels in setkernels.h and the results are joined
+     * Small FlatSets are merged by one thread
+     */
+    FlatSet& unite(const FlatSet& S, unsigned n_threads = 0);
+    FlatSet& intersect(const FlatSet& S, unsigned n_threads = 0);
+    FlatSet& subtract(const FlatSet& S, unsigned n_threads = 0);
+
+private:
+    std::vector<int> values;  // sorted, without repetitions
+
+    // The merge kernels of setkernels.h
+    using Kernel = std::size_t (*)(const int* a, std::size_t na, const int* b, std::size_t nb, int* out);
+
+    /*
+     * Replace the values by kernel(values, S.values), computed by n_threads threads
+     */
+    void parallel_merge(const FlatSet& S, unsigned n_threads, Kernel kernel);
+
+    /*
+     * Write FlatSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    friend std::ostream& operator<<(std::ostream& os, const FlatSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    friend FlatSet operator+(FlatSet S1, const FlatSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend FlatSet operator*(FlatSet S1, const FlatSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend FlatSet operator-(FlatSet S1, const FlatSet& S2) {
+        return (S1 -= S2);
+    }
+};
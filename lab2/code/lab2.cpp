@@ -2,8 +2,33 @@
 #include <iomanip>
 #include <sstream>
 #include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <random>
+#include <fstream>
+#include <filesystem>
+#include <list>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <unordered_set>
+#include <limits>
+#include <set>
 
 #include "set.h"
+#include "flatset.h"
+#include "bitmapset.h"
+#include "setkernels.h"
+#include "parallelsort.h"
+#include "concurrentset.h"
+#include "persistentset.h"
+#include "setfile.h"
+#include "unrolledset.h"
+#include "settelemetry.h"
+#include "smallset.h"
+#include "packedset.h"
+#include "compactset.h"
+#include "bufferedset.h"
 
 int main() {
     /*****************************************************
@@ -304,6 +329,1417 @@ int main() {
         assert(S2 == Set{A2});
     }
 
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 10                                      *
+     * Lazy expressions: fused evaluation of several      *
+     * operators and symmetric difference                 *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 10: fused expressions and operator^\n";
+
+    {
+        Set S1{std::vector<int>{1, 2, 3, 4}};
+        Set S2{std::vector<int>{3, 4, 5, 6}};
+        Set S3{std::vector<int>{2, 4, 6, 8}};
+        Set S4{std::vector<int>{6}};
+        assert(Set::get_count_nodes() == 21);
+
+        // No intermediate Set is created: only the nodes of S5
+        Set S5 = (S1 + S2) * S3 - S4;
+        assert(Set::get_count_nodes() == 25);
+        assert(S5 == Set(std::vector<int>{2, 4}));
+
+        Set S6 = S1 ^ S2;
+        assert(S6 == Set(std::vector<int>{1, 2, 5, 6}));
+        assert((S1 ^ S1) == Set{});
+        assert((S1 ^ Set{}) == S1);
+        assert((S3 ^ 9 ^ 2) == Set(std::vector<int>{4, 6, 8, 9}));
+
+        S6 ^= S3;
+        assert(S6 == Set(std::vector<int>{1, 4, 5, 8}));
+
+        // An expression can own temporary Sets and be evaluated several times
+        auto expr = Set{std::vector<int>{0, 4, 7}} - S1 + 9;
+        assert(Set{expr} == Set(std::vector<int>{0, 7, 9}));
+        assert(Set{expr} == Set(std::vector<int>{0, 7, 9}));
+
+        std::ostringstream os{};
+        os << (S1 * S2) << " " << (S1 * S4);
+        assert((os.str() == std::string{"{ 3 4 } Set is empty!"}));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 11                                      *
+     * Express lanes: is_member and lower_bound           *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 11: express lanes, is_member and lower_bound\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 1000; ++i) {
+            A1.push_back(3 * i);
+        }
+
+        Set S1{A1};
+        S1.enable_index();
+        assert(S1.has_index());
+        assert(Set::get_count_nodes() == 1002);  // the lanes do not create nodes
+
+        // Test
+        for (int i = -3; i < 3003; ++i) {
+            assert(S1.is_member(i) == (i >= 0 && i < 3000 && i % 3 == 0));
+            assert(S1.lower_bound(i) == (i <= 2997 ? std::optional<int>{std::max(0, (i + 2) / 3 * 3)}
+                                                   : std::nullopt));
+        }
+
+        // The lanes follow the changes of the list
+        S1 += Set{std::vector<int>{1, 1501, 5000}};
+        assert(S1.is_member(1501) && S1.is_member(5000) && S1.lower_bound(1500) == 1500);
+
+        S1 -= Set{std::vector<int>{0, 1500, 1501}};
+        assert(!S1.is_member(1500) && !S1.is_member(0) && S1.lower_bound(1500) == 1503);
+
+        S1 *= Set{std::vector<int>{1, 3, 2997, 2998}};
+        assert(S1 == Set(std::vector<int>{1, 3, 2997}));
+        assert(S1.lower_bound(4) == 2997 && S1.lower_bound(2998) == std::nullopt);
+
+        S1.make_empty();
+        assert(!S1.is_member(3) && S1.lower_bound(-5) == std::nullopt);
+
+        S1.disable_index();
+        assert(!S1.has_index());
+        assert(Set{A1}.lower_bound(4) == 6);
+
+        // Values appended after the last one extend the lanes, values crowded in one gap split it
+        S1.enable_index();
+        for (int i = 0; i < 2000; ++i) {
+            S1.insert(1000 * i);
+            assert(S1.is_member(1000 * i) && S1.lower_bound(1000 * i - 999) == 1000 * i);
+        }
+        for (int i = 1; i < 500; ++i) {
+            S1.insert(500000 + i);
+            assert(S1.lower_bound(500000 + i) == 500000 + i && !S1.is_member(500000 + i + 1));
+        }
+        for (int i = 1; i < 500; i += 2) {
+            S1.erase(500000 + i);
+        }
+        for (int i = 0; i < 1000; ++i) {
+            assert(S1.lower_bound(500000 + i) == (i == 0 ? 500000 : (i < 499 ? (i + 1) / 2 * 2 + 500000 : 501000)));
+        }
+        assert(S1.cardinality() == 2000 + 249);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 12                                      *
+     * Galloping: *=, -= and <=> with sets of very        *
+     * different sizes                                    *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 12: galloping through express lanes\n";
+
+    {
+        std::vector<int> A1;
+        for (int i = 0; i < 10000; ++i) {
+            A1.push_back(2 * i);
+        }
+        std::vector<int> A2{-1, 0, 7, 4000, 4001, 19998, 20000};
+        std::vector<int> A3{0, 4000, 19998};
+
+        Set S1{A1};
+        S1.enable_index();
+
+        // Test: small *= large and small -= large
+        Set S2{A2};
+        S2 *= S1;
+        assert(S2 == Set{A3});
+
+        Set S3{A2};
+        S3 -= S1;
+        assert(S3 == Set(std::vector<int>{-1, 7, 4001, 20000}));
+
+        // Test: subsets
+        assert(Set{A3} < S1);
+        assert(S1 > Set{A3});
+        assert((Set{A2} <=> S1) == std::partial_ordering::unordered);
+        assert((S1 <=> Set{A2}) == std::partial_ordering::unordered);
+
+        // Test: large -= small, the lanes are kept up to date
+        S1 -= Set{A2};
+        assert(S1.cardinality() == 9997);
+        assert(!S1.is_member(0) && !S1.is_member(4000) && !S1.is_member(19998));
+        assert(S1.is_member(2) && S1.is_member(3998) && S1.is_member(4002) && S1.is_member(19996));
+        assert(S1.lower_bound(4000) == 4002 && S1.lower_bound(19997) == std::nullopt);
+
+        // Remove every lane entry around a position, one at a time
+        for (int v = 100; v < 200; v += 2) {
+            S1 -= v;
+            assert(!S1.is_member(v) && S1.lower_bound(v) == v + 2);
+        }
+        assert(S1.cardinality() == 9947);
+        assert(Set::get_count_nodes() == 9960);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 13                                      *
+     * FlatSet: contiguous storage and vectorized         *
+     * merge kernels                                      *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 13: FlatSet and merge kernels\n";
+
+    {
+        std::vector<int> A1{1, 3, 5, 8};
+        std::vector<int> A2{2, 3, 7};
+
+        Set S1{A1};
+        FlatSet F1{S1};
+        FlatSet F2{A2};
+
+        // Test
+        std::ostringstream os{};
+        os << F1 << " " << F2 << " " << FlatSet{};
+        assert((os.str() == std::string{"{ 1 3 5 8 } { 2 3 7 } Set is empty!"}));
+
+        assert(F1.to_set() == S1);
+        assert(F1.is_member(5) && !F1.is_member(4));
+        assert((F1 + F2) == FlatSet(std::vector<int>{1, 2, 3, 5, 7, 8}));
+        assert((F1 * F2) == FlatSet{3});
+        assert((F1 - F2) == FlatSet(std::vector<int>{1, 5, 8}));
+        assert(F1 * F2 < F1 && F1 > 3 && (F1 <=> F2) == std::partial_ordering::unordered);
+
+        // Every version of the kernels gives the same result as the standard algorithms
+        std::mt19937 gen{2024};
+        auto random_values = [&gen](int n, int range) {
+            std::uniform_int_distribution<int> dist{-range, range};
+            std::vector<int> V;
+            for (int i = 0; i < n; ++i) {
+                V.push_back(dist(gen));
+            }
+            std::sort(V.begin(), V.end());
+            V.erase(std::unique(V.begin(), V.end()), V.end());
+            return V;
+        };
+
+        const setkernels::Isa best = setkernels::best_isa();
+        for (auto isa : {setkernels::Isa::scalar, setkernels::Isa::sse41, setkernels::Isa::avx2}) {
+            if (!setkernels::use_isa(isa)) continue;
+
+            for (int trial = 0; trial < 200; ++trial) {
+                std::vector<int> V1 = random_values(static_cast<int>(gen() % 300), 200);
+                std::vector<int> V2 = random_values(static_cast<int>(gen() % 300), 200);
+                std::vector<int> expected;
+
+                std::set_union(V1.begin(), V1.end(), V2.begin(), V2.end(), std::back_inserter(expected));
+                assert((FlatSet{V1} + FlatSet{V2}).to_vector() == expected);
+
+                expected.clear();
+                std::set_intersection(V1.begin(), V1.end(), V2.begin(), V2.end(), std::back_inserter(expected));
+                assert((FlatSet{V1} * FlatSet{V2}).to_vector() == expected);
+
+                expected.clear();
+                std::set_difference(V1.begin(), V1.end(), V2.begin(), V2.end(), std::back_inserter(expected));
+                assert((FlatSet{V1} - FlatSet{V2}).to_vector() == expected);
+            }
+        }
+        setkernels::use_isa(best);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 14                                      *
+     * BitmapSet: array, bitmap and run containers        *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 14: BitmapSet\n";
+
+    {
+        std::vector<int> A1{-70000, -3, 1, 3, 5, 8, 65536, 2000000000};
+        std::vector<int> A2{-3, 2, 3, 7, 65536};
+
+        Set S1{A1};
+        BitmapSet B1{S1};
+        BitmapSet B2{A2};
+
+        // Test
+        std::ostringstream os{};
+        os << B2 << " " << BitmapSet{};
+        assert((os.str() == std::string{"{ -3 2 3 7 65536 } Set is empty!"}));
+
+        assert(B1.to_set() == S1 && B1.cardinality() == 8);
+        assert(B1.is_member(-70000) && B1.is_member(65536) && !B1.is_member(65537));
+        assert((B1 * B2) == BitmapSet(std::vector<int>{-3, 3, 65536}));
+        assert((B1 - B2).to_set() == Set{A1} - Set{A2});
+        assert((B1 + B2).to_set() == Set{A1} + Set{A2});
+        assert(B1 * B2 < B1 && (B1 <=> B2) == std::partial_ordering::unordered);
+
+        // Dense, sparse and clustered values use bitmap, array and run containers
+        std::vector<int> dense, sparse, clustered;
+        for (int i = 0; i < 200000; ++i) {
+            if (i % 7 != 0) dense.push_back(i);
+            if (i % 1000 == 0) sparse.push_back(i * 37);
+            if (i % 5000 < 800) clustered.push_back(i);
+        }
+        BitmapSet D{dense}, Sp{sparse}, C{clustered};
+        assert(D.to_vector() == dense && Sp.to_vector() == sparse && C.to_vector() == clustered);
+        assert(C.size_in_bytes() < clustered.size());
+        assert(D.size_in_bytes() < dense.size() / 4);
+
+        auto check = [](const std::vector<int>& V1, const std::vector<int>& V2) {
+            Set S1{V1}, S2{V2};
+            BitmapSet B1{V1}, B2{V2};
+            assert((B1 + B2).to_set() == S1 + S2);
+            assert((B1 * B2).to_set() == S1 * S2);
+            assert((B1 - B2).to_set() == S1 - S2);
+            assert((B2 - B1).to_set() == S2 - S1);
+            assert((B1 <=> B2) == (S1 <=> S2) && ((B1 * B2) <=> B1) == (Set{S1 * S2} <=> S1));
+            assert(((B1 - B2) <=> (B1 + B2)) == std::partial_ordering::less || (B1 - B2) == (B1 + B2));
+        };
+        check(dense, sparse);
+        check(dense, clustered);
+        check(sparse, clustered);
+        check(clustered, clustered);
+
+        // Single values: containers change representation when needed
+        BitmapSet B3{clustered};
+        for (int i = 0; i < 200000; i += 3) {
+            B3.insert(i);
+        }
+        for (int i = 0; i < 200000; i += 2) {
+            B3.erase(i);
+        }
+        std::vector<int> A3;
+        for (int i = 0; i < 200000; ++i) {
+            if (i % 2 != 0 && (i % 3 == 0 || i % 5000 < 800)) A3.push_back(i);
+        }
+        assert(B3.to_vector() == A3 && B3.cardinality() == A3.size());
+        assert(B3 == BitmapSet{A3} && B3.size_in_bytes() <= 2 * BitmapSet{A3}.size_in_bytes());
+
+        // Value by value, containers take the same representation, and about the same memory, as built at once
+        std::vector<int> A4(4096);
+        std::iota(A4.begin(), A4.end(), 0);
+        BitmapSet B4;
+        for (int val : A4) {
+            B4.insert(val);
+        }
+        assert(B4 == BitmapSet{A4} && B4.size_in_bytes() <= 2 * BitmapSet{A4}.size_in_bytes());
+        for (int val = 1; val < 4096; val += 2) {
+            B4.erase(val);
+        }
+        std::erase_if(A4, [](int val) { return val % 2 != 0; });
+        assert(B4 == BitmapSet{A4} && B4.size_in_bytes() <= 2 * BitmapSet{A4}.size_in_bytes());
+        assert(B4 < BitmapSet{dense} + B4 && !(B4 <= BitmapSet{dense}) && BitmapSet{A4} * C <= C);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+
+    /*****************************************************
+     * TEST PHASE 15                                      *
+     * Bulk construction from unsorted values             *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 15: bulk construction from unsorted values\n";
+
+    {
+        std::vector<int> A1{5, -1, 3, 5, 5, 8, -1, 0};
+        std::vector<int> A2{-1, 0, 3, 5, 8};
+
+        // Test: vector, any range, iterator pair
+        assert(Set::from_unsorted(A1) == Set{A2});
+        assert(Set::from_unsorted(std::list<int>(A1.begin(), A1.end())) == Set{A2});
+        assert(Set::from_unsorted(A1.begin() + 1, A1.begin() + 4) == Set(std::vector<int>{-1, 3, 5}));
+        assert(Set::from_unsorted(std::vector<int>{}).is_empty());
+        assert(FlatSet::from_unsorted(A1) == FlatSet{A2});
+
+        // Test: large input, sorted in several slices by several threads
+        std::mt19937 gen{31};
+        std::uniform_int_distribution<int> dist{-100000, 100000};
+        std::vector<int> A3(500000);
+        for (int& val : A3) {
+            val = dist(gen);
+        }
+        std::vector<int> A4{A3};
+        std::sort(A4.begin(), A4.end());
+        A4.erase(std::unique(A4.begin(), A4.end()), A4.end());
+
+        for (unsigned n_threads : {1u, 3u, 4u}) {
+            std::vector<int> A5{A3};
+            parallel_sort_unique(A5, n_threads);
+            assert(A5 == A4);
+        }
+        assert(Set::from_unsorted(A3).to_vector() == A4);
+        assert(FlatSet::from_unsorted(A3).to_vector() == A4);
+
+        // Test: file
+        const auto file = std::filesystem::temp_directory_path() / "lab2_from_file.txt";
+        {
+            std::ofstream os{file};
+            os << "5 -1\n3 5\t5 8 -1 0\n";
+        }
+        assert(Set::from_file(file) == Set{A2});
+        std::filesystem::remove(file);
+        assert(Set::from_file(file).is_empty());
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 16                                      *
+     * k-way union and intersection                       *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 16: union_all and intersect_all\n";
+
+    {
+        std::vector<Set> V;
+        V.push_back(Set(std::vector<int>{1, 3, 5, 7, 9}));
+        V.push_back(Set(std::vector<int>{3, 4, 5, 9}));
+        V.push_back(Set(std::vector<int>{-2, 3, 5, 9, 11}));
+
+        // Test: small sets
+        assert(Set::union_all(V) == Set(std::vector<int>{-2, 1, 3, 4, 5, 7, 9, 11}));
+        assert(Set::intersect_all(V) == Set(std::vector<int>{3, 5, 9}));
+        assert(Set::union_all(std::span<const Set>{V}.first(1)) == V[0]);
+        assert(Set::intersect_all(std::span<const Set>{V}.first(1)) == V[0]);
+        assert(Set::union_all({}).is_empty());
+        assert(Set::intersect_all({}).is_empty());
+
+        V.push_back(Set{});
+        assert(Set::union_all(V) == Set(std::vector<int>{-2, 1, 3, 4, 5, 7, 9, 11}));
+        assert(Set::intersect_all(V).is_empty());
+
+        // Test: many large sets, compared with pairwise += and *=
+        // Sets 0, 5, 10, ... are indexed and large, so that the intersection gallops through them
+        std::mt19937 gen{32};
+        V.clear();
+        for (int k = 0; k < 12; ++k) {
+            std::vector<int> A;
+            const int step = (k % 5 == 0) ? 1 : 2 + k % 3;
+            for (int i = -k; i < 240000; ++i) {
+                if (i % step == 0 && gen() % 8 != 0) A.push_back(i);
+            }
+            V.push_back(Set{A});
+            if (k % 5 == 0) V.back().enable_index();
+        }
+        Set U;
+        Set I{V[0]};
+        for (const Set& S : V) {
+            U += S;
+            I *= S;
+        }
+        assert(!I.is_empty());
+
+        for (unsigned n_threads : {1u, 3u, 0u}) {
+            const Set U1 = Set::union_all(V, n_threads);
+            const Set I1 = Set::intersect_all(V, n_threads);
+            assert(U1 == U && I1 == I);
+        }
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 17                                      *
+     * ConcurrentSet                                      *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 17: ConcurrentSet\n";
+
+    {
+        // Test: one thread
+        ConcurrentSet C1{Set(std::vector<int>{1, 3, 5})};
+        assert(C1.cardinality() == 3 && C1.is_member(3) && !C1.is_member(4));
+        assert(C1.insert(4) && !C1.insert(4) && C1.is_member(4));
+        assert(C1.erase(1) && !C1.erase(1) && !C1.is_member(1));
+        assert(C1.insert(-7) && C1.insert(9));
+        assert(C1.to_set() == Set(std::vector<int>{-7, 3, 4, 5, 9}));
+
+        std::ostringstream os;
+        os << C1;
+        assert(os.str() == "{ -7 3 4 5 9 }");
+
+        ConcurrentSet C2;
+        assert(C2.is_empty() && !C2.erase(0));
+
+        // Test: writers insert and erase interleaved values, while readers look up the values never erased
+        // Odd values are inserted once and never erased, even values are inserted and erased many times
+        constexpr int n = 4000;
+        constexpr int n_writers = 4;
+        constexpr int n_readers = 4;
+        ConcurrentSet C3;
+        for (int i = 1; i < n; i += 2) {
+            C3.insert(i);
+        }
+        std::atomic<bool> failed{false};
+        {
+            std::vector<std::jthread> threads;
+            for (int w = 0; w < n_writers; ++w) {
+                threads.emplace_back([&, w] {
+                    for (int round = 0; round < 3; ++round) {
+                        for (int i = 2 * w; i < n; i += 2 * n_writers) {
+                            if (!C3.insert(i)) failed = true;
+                        }
+                        for (int i = 2 * w; i < n; i += 2 * n_writers) {
+                            if (!C3.erase(i)) failed = true;
+                        }
+                    }
+                    for (int i = 2 * w; i < n; i += 2 * n_writers) {
+                        if (!C3.insert(i)) failed = true;
+                    }
+                });
+            }
+            for (int r = 0; r < n_readers; ++r) {
+                threads.emplace_back([&, r] {
+                    for (int i = 1 + 2 * r; i < n; i += 2 * n_readers) {
+                        if (!C3.is_member(i)) failed = true;
+                    }
+                });
+            }
+        }  // join
+        assert(!failed);
+        assert(C3.cardinality() == n);
+
+        std::vector<int> A(n);
+        std::iota(A.begin(), A.end(), 0);
+        assert(C3.to_vector() == A);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 18                                      *
+     * PersistentSet                                      *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 18: PersistentSet\n";
+
+    {
+        // Test: operations, compared with class Set
+        std::mt19937 gen{34};
+        for (int round = 0; round < 50; ++round) {
+            std::uniform_int_distribution<int> dist{-300, 300};
+            std::vector<int> A1, A2;
+            for (int i = 0; i < 200; ++i) {
+                A1.push_back(dist(gen));
+                A2.push_back(dist(gen) / (1 + round % 4));
+            }
+            const Set S1 = Set::from_unsorted(A1);
+            const Set S2 = Set::from_unsorted(A2);
+            const PersistentSet P1{S1};
+            const PersistentSet P2{S2};
+
+            assert(P1.to_set() == S1 && P1.cardinality() == S1.cardinality());
+            assert((P1 + P2).to_set() == S1 + S2);
+            assert((P1 * P2).to_set() == S1 * S2);
+            assert((P1 - P2).to_set() == S1 - S2);
+            assert((P1 == P2) == (S1 == S2));
+            assert((P1 <=> P2) == (S1 <=> S2));
+            assert(((P1 * P2) <=> P1) == std::partial_ordering::less || P1 * P2 == P1);
+            assert((P1 + P2) == (P2 + P1));
+            for (int val = -310; val <= 310; val += 7) {
+                assert(P1.is_member(val) == S1.is_member(val));
+            }
+        }
+
+        // Test: snapshots are not modified by later changes
+        PersistentSet P3{std::vector<int>{1, 3, 5}};
+        const PersistentSet snapshot{P3};
+        P3.insert(4);
+        P3.erase(1);
+        P3 += PersistentSet{std::vector<int>{7, 9}};
+        assert(P3 == PersistentSet(std::vector<int>{3, 4, 5, 7, 9}));
+        assert(snapshot == PersistentSet(std::vector<int>{1, 3, 5}));
+
+        std::ostringstream os;
+        os << P3 << " " << PersistentSet{};
+        assert(os.str() == "{ 3 4 5 7 9 } Set is empty!");
+
+        // Test: the tree shape does not depend on how the set was built
+        PersistentSet P4;
+        for (int val : {9, 4, 7, 3, 5}) {
+            P4.insert(val);
+        }
+        assert(P4 == P3 && (P4 <=> P3) == std::partial_ordering::equivalent);
+        assert((P4 - P3).is_empty() && (P4 * P3) == P3);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 19                                      *
+     * Cardinality-only queries                           *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 19: cardinality-only queries\n";
+
+    {
+        const Set S1{std::vector<int>{1, 3, 5, 7, 9}};
+        const Set S2{std::vector<int>{2, 3, 4, 9, 10, 11}};
+        const Set S3{std::vector<int>{2, 4, 6}};
+        const Set S4{};
+
+        assert(S1.intersection_size(S2) == 2 && S2.intersection_size(S1) == 2);
+        assert(S1.union_size(S2) == 9);
+        assert(S1.difference_size(S2) == 3 && S2.difference_size(S1) == 4);
+        assert(S1.jaccard(S2) == 2.0 / 9.0);
+        assert(S1.jaccard(S1) == 1.0 && S1.jaccard(S4) == 0.0 && S4.jaccard(S4) == 1.0);
+        assert(S1.intersects(S2) && !S1.is_disjoint(S2));
+        assert(S1.is_disjoint(S3) && !S1.intersects(S4) && S4.is_disjoint(S4));
+
+        // Test: lazy expressions are counted without building a Set
+        assert((S1 * S2).cardinality() == 2 && ((S1 + S2) - S3).cardinality() == 7);
+        assert((S1 * S3).is_empty() && !(S1 ^ (S1 + 2)).is_empty());
+
+        // Test: galloping through a large indexed Set
+        std::vector<int> A;
+        for (int i = 0; i < 100000; ++i) {
+            A.push_back(3 * i);
+        }
+        Set S5{A};
+        S5.enable_index();
+        const Set S6{std::vector<int>{-3, 0, 5, 6, 299997, 300000}};
+        assert(S5.intersection_size(S6) == 3 && S6.intersection_size(S5) == 3);
+        assert(S6.difference_size(S5) == 3 && S5.union_size(S6) == 100003);
+        assert(S5.intersects(S6) && S5.is_disjoint(Set{std::vector<int>{1, 2, 4}}));
+        assert(Set::get_count_nodes() == 100000 + 20 + 2 * 6);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 20                                      *
+     * Set fingerprint and hashing                        *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 20: fingerprint and std::hash<Set>\n";
+
+    {
+        const Set S1{std::vector<int>{1, 3, 5, 7}};
+        const Set S2{std::vector<int>{3, 5, 6, 8}};
+        assert(Set{}.hash() == 0 && S1.hash() != S2.hash());
+
+        // Test: the hash depends only on the values, however the Set was built or modified
+        Set S3{S1};
+        S3 += S2;
+        S3 -= Set{std::vector<int>{6, 8}};
+        assert(S3 == S1 && S3.hash() == S1.hash());
+        S3 *= S2;
+        assert(S3.hash() == Set(std::vector<int>{3, 5}).hash());
+        S3 ^= S1;
+        assert(S3.hash() == Set(std::vector<int>{1, 7}).hash());
+        assert(Set{S1 * S2 + 9}.hash() == Set(std::vector<int>{3, 5, 9}).hash());
+        assert(Set::union_all(std::vector<Set>{S1, S2}).hash() == Set{S1 + S2}.hash());
+
+        Set S4{std::move(S3)};
+        assert(S3.hash() == 0 && S4.hash() == Set(std::vector<int>{1, 7}).hash());
+        S4.make_empty();
+        assert(S4.hash() == 0);
+
+        // Test: Sets with the same cardinality and different values are not equal
+        assert(!(S1 == S2) && (S1 <=> S2) == std::partial_ordering::unordered);
+
+        // Test: Sets as keys of an unordered container
+        std::unordered_set<Set> U;
+        U.insert(S1);
+        U.insert(S2);
+        U.insert(Set{S1 + S2 - S2 + S1});
+        assert(U.size() == 2 && U.contains(S1) && U.contains(S2) && !U.contains(Set{S1 * S2}));
+        assert(std::hash<Set>{}(S1) == static_cast<std::size_t>(S1.hash()));
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 21                                      *
+     * Iterators, insert and erase                        *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 21: iterators, insert and erase\n";
+
+    {
+        static_assert(std::bidirectional_iterator<Set::const_iterator>);
+        static_assert(std::ranges::bidirectional_range<const Set>);
+
+        Set S1{std::vector<int>{1, 3, 5}};
+        assert(std::vector<int>(S1.begin(), S1.end()) == S1.to_vector());
+        assert(std::vector<int>(std::make_reverse_iterator(S1.end()), std::make_reverse_iterator(S1.begin())) ==
+               std::vector<int>({5, 3, 1}));
+        const Set S0;
+        assert(S0.begin() == S0.end());
+
+        // Test: find, insert and erase
+        assert(*S1.find(3) == 3 && S1.find(4) == S1.end() && S1.find(9) == S1.end());
+        [[maybe_unused]] auto [it1, inserted1] = S1.insert(4);
+        assert(inserted1 && *it1 == 4 && *std::prev(it1) == 3 && *std::next(it1) == 5);
+        [[maybe_unused]] auto [it2, inserted2] = S1.insert(4);
+        assert(!inserted2 && it2 == it1);
+        assert(S1.erase(1) == 1 && S1.erase(1) == 0);
+        assert(*S1.erase(S1.find(4)) == 5);
+        assert(S1 == Set(std::vector<int>{3, 5}) && S1.cardinality() == 2);
+        assert(S1.hash() == Set(std::vector<int>{3, 5}).hash());
+
+        // Test: hinted insert, right and wrong hints
+        [[maybe_unused]] auto it3 = S1.insert(S1.end(), 8);
+        assert(*it3 == 8 && std::next(it3) == S1.end());
+        assert(*S1.insert(S1.begin(), -1) == -1);
+        assert(*S1.insert(S1.begin(), 7) == 7);  // wrong hint
+        assert(*S1.insert(S1.find(5), 5) == 5);  // already in the Set
+        assert(S1 == Set(std::vector<int>{-1, 3, 5, 7, 8}));
+
+        // Test: std algorithms, streaming sorted values with std::inserter
+        Set S2;
+        std::vector<int> A(100000);
+        std::iota(A.begin(), A.end(), -50000);
+        std::copy(A.begin(), A.end(), std::inserter(S2, S2.end()));
+        assert(S2 == Set{A});
+
+        std::vector<int> A2;
+        std::ranges::set_intersection(S1, S2, std::back_inserter(A2));
+        assert(A2 == Set{S1 * S2}.to_vector());
+        assert(std::ranges::count_if(S2, [](int val) { return val % 2 == 0; }) == 50000);
+        assert(std::ranges::find(S1, 7) == S1.find(7));
+
+        // Test: erasing while iterating, with express lanes
+        S2.enable_index();
+        for (auto it = S2.begin(); it != S2.end();) {
+            it = (*it % 3 == 0) ? S2.erase(it) : std::next(it);
+        }
+        assert(S2.cardinality() == 66667 && !S2.is_member(3) && S2.is_member(4) && *S2.find(-49999) == -49999);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 22                                      *
+     * Binary Set files                                   *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 22: binary files and MappedSet\n";
+
+    {
+        const auto file = std::filesystem::temp_directory_path() / "lab2_binary.set";
+
+        // Test: small Sets, including negative values and the extremes of int
+        for (const std::vector<int>& A : {std::vector<int>{}, std::vector<int>{7},
+                                          std::vector<int>{std::numeric_limits<int>::min(), -5, 0, 3,
+                                                           std::numeric_limits<int>::max()}}) {
+            const Set S1{A};
+            assert(write_binary(S1, file));
+            assert(read_binary(file) == S1);
+
+            const MappedSet M{file};
+            assert(M.is_open() && M.cardinality() == S1.cardinality() && M.to_vector() == A);
+            for ([[maybe_unused]] int val : {std::numeric_limits<int>::min(), -6, -5, 0, 1, 7, std::numeric_limits<int>::max()}) {
+                assert(M.is_member(val) == S1.is_member(val));
+            }
+        }
+
+        // Test: several blocks, dense and sparse values
+        std::vector<int> A2;
+        for (int i = 0; i < 1000; ++i) {
+            A2.push_back(i * i - 300000);
+        }
+        const Set S2{A2};
+        assert(write_binary(S2, file));
+        assert(std::filesystem::file_size(file) < 24 + 16 * 8 + 3 * 1000);
+        const MappedSet M2{file};
+        assert(M2.to_set() == S2);
+        for (int val = -300001; val < 700000; val += 97) {
+            assert(M2.is_member(val) == S2.is_member(val));
+        }
+        for ([[maybe_unused]] int val : A2) {
+            assert(M2.is_member(val));
+        }
+
+        // Test: corrupt files, a delta of 0 in block 0 and block first values not increasing
+        {
+            std::fstream fs{file, std::ios::in | std::ios::out | std::ios::binary};
+            fs.seekp(24 + 16 * 8);
+            fs.put('\0');
+        }
+        assert(MappedSet{file}.is_open() && MappedSet{file}.to_vector().empty() && read_binary(file).is_empty());
+        assert(write_binary(S2, file));
+        {
+            std::fstream fs{file, std::ios::in | std::ios::out | std::ios::binary};
+            const unsigned char first0[4] = {0x20, 0x6c, 0xfb, 0xff};  // -300000, little-endian
+            fs.seekp(24 + 16);
+            fs.write(reinterpret_cast<const char*>(first0), 4);  // block 1 starts with the first value of block 0
+        }
+        assert(!MappedSet{file}.is_open() && read_binary(file).is_empty());
+
+        // Test: files that are not Set files
+        {
+            std::ofstream os{file};
+            os << "{ 1 2 3 }";
+        }
+        assert(!MappedSet{file}.is_open() && read_binary(file).is_empty());
+        std::filesystem::remove(file);
+        assert(!MappedSet{file}.is_open() && read_binary(file).is_empty());
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 23                                      *
+     * UnrolledSet                                        *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 23: UnrolledSet\n";
+
+    {
+        // Test: operations, compared with class Set, on sets spanning many blocks
+        std::mt19937 gen{39};
+        for (int round = 0; round < 40; ++round) {
+            std::uniform_int_distribution<int> dist{-500, 500};
+            std::vector<int> A1, A2;
+            for (int i = 0; i < 300; ++i) {
+                A1.push_back(dist(gen));
+                A2.push_back(dist(gen) / (1 + round % 3));
+            }
+            const Set S1 = Set::from_unsorted(A1);
+            const Set S2 = Set::from_unsorted(A2);
+            const UnrolledSet U1{S1};
+            const UnrolledSet U2{S2};
+
+            assert(U1.to_set() == S1 && U1.cardinality() == S1.cardinality());
+            assert((U1 + U2).to_set() == S1 + S2);
+            assert((U1 * U2).to_set() == S1 * S2);
+            assert((U1 - U2).to_set() == S1 - S2);
+            assert((U1 - U1).is_empty() && (U1 * U1) == U1);
+            assert((U1 == U2) == (S1 == S2) && (U1 <=> U2) == (S1 <=> S2));
+            assert(((U1 * U2) <=> U1) == (Set{S1 * S2} <=> S1));
+            for (int val = -510; val <= 510; val += 3) {
+                assert(U1.is_member(val) == S1.is_member(val));
+            }
+        }
+        assert(UnrolledSet::get_count_blocks() == 0);
+
+        // Test: insert splits blocks and erase merges them
+        UnrolledSet U3;
+        Set S3;
+        for (int i = 0; i < 2000; ++i) {
+            const int val = (i * 7919) % 2000;  // all values in [0, 2000), in scrambled order
+            assert(U3.insert(val) && !U3.insert(val));
+            S3.insert(val);
+        }
+        assert(U3.to_set() == S3 && U3.cardinality() == 2000);
+        assert(UnrolledSet::get_count_blocks() <= 2 + 2000 / 13 + 1);
+        for (int val = 0; val < 2000; ++val) {
+            if (val % 10 != 0) {
+                assert(U3.erase(val) && !U3.erase(val));
+                S3.erase(val);
+            }
+        }
+        assert(U3.to_set() == S3 && U3.cardinality() == 200);
+        assert(UnrolledSet::get_count_blocks() <= 2 + 2 * 200 / 13 + 1);
+
+        std::ostringstream os;
+        os << UnrolledSet{std::vector<int>{1, 2, 3}} << " " << UnrolledSet{};
+        assert(os.str() == "{ 1 2 3 } Set is empty!");
+
+        UnrolledSet U4{U3};
+        U4 = UnrolledSet{5} + U4;
+        assert(U4.cardinality() == 201 && U3.cardinality() == 200);
+    }
+
+    assert(UnrolledSet::get_count_blocks() == 0);
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 24                                      *
+     * Telemetry                                          *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 24: Telemetry\n";
+
+    {
+        using settelemetry::Operation;
+        settelemetry::reset();
+        {
+            Set S1{std::vector<int>{1, 3, 5, 7}};  // 6 nodes
+            Set S2{S1};                            // 6 nodes
+            S2 += Set{std::vector<int>{2, 4}};     // 4 + 2 nodes
+            assert(S1.is_member(3) && !S1.is_member(4));
+            assert(S1 != S2 && (S1 <=> S2) == std::partial_ordering::less);
+        }
+        const settelemetry::Snapshot T = settelemetry::snapshot();
+
+        if constexpr (settelemetry::enabled) {
+            assert(T.nodes_allocated == 18 && T.nodes_freed == 18 && T.live_nodes == 0);
+            assert(T.peak_live_nodes == 18 && T.peak_bytes >= 18 * sizeof(int));
+            assert(T[Operation::construct].calls == 2 && T[Operation::copy].calls == 1);
+            assert(T[Operation::is_member].calls == 2 && T[Operation::unite].calls == 1);
+            assert(T[Operation::compare].calls == 1 && T[Operation::intersect].calls == 0);
+
+            std::uint64_t calls = 0;
+            for (std::uint64_t count : T[Operation::is_member].histogram) calls += count;
+            assert(calls == 2);
+            assert(T.to_json().find("\"is_member\": {\"calls\": 2") != std::string::npos);
+        } else {
+            assert(T.nodes_allocated == 0 && T[Operation::is_member].calls == 0);
+            assert(T.to_json().starts_with("{\"enabled\": false"));
+        }
+        assert(T.to_json().ends_with("}}"));
+        assert(std::string{settelemetry::name(Operation::unite)} == "+=");
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 25                                      *
+     * SmallSet                                           *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 25: SmallSet\n";
+
+    {
+        // Test: small sets are stored inline, no Set nodes are created
+        SmallSet<8> S1{std::vector<int>{1, 3, 5}};
+        SmallSet<8> S2 = S1 + SmallSet<8>{4};
+        SmallSet<8> S3;
+        assert(S1.is_inline() && S2.is_inline() && S3.is_inline() && S3.is_empty());
+        assert(S2.cardinality() == 4 && S2.is_member(4) && !S1.is_member(4));
+        assert((S1 <=> S2) == std::partial_ordering::less && S1 != S2 && S1 == S2 - 4);
+        assert(Set::get_count_nodes() == 0);
+
+        // Test: spill past 8 values, move back inline at 4 values
+        for (int val = 0; val < 20; val += 2) {
+            S3.insert(val);
+        }
+        assert(!S3.is_inline() && S3.cardinality() == 10 && !S3.insert(0));
+        for (int val = 0; val < 12; val += 2) {
+            assert(S3.erase(val) && !S3.erase(val));
+        }
+        assert(S3.is_inline() && S3.to_vector() == std::vector<int>({12, 14, 16, 18}));
+
+        std::ostringstream os;
+        os << S3 << " " << SmallSet<8>{};
+        assert(os.str() == "{ 12 14 16 18 } Set is empty!");
+    }
+    assert(Set::get_count_nodes() == 0);
+
+    {
+        // Test: operations, compared with class Set, on inline, spilled and mixed operands
+        std::mt19937 gen{42};
+        for (int round = 0; round < 300; ++round) {
+            std::uniform_int_distribution<int> size{0, 24};
+            std::uniform_int_distribution<int> dist{0, 30};
+            std::vector<int> A1(size(gen)), A2(size(gen));
+            for (int& val : A1) val = dist(gen);
+            for (int& val : A2) val = dist(gen);
+            const Set T1 = Set::from_unsorted(A1);
+            const Set T2 = Set::from_unsorted(A2);
+            const SmallSet<8> S1{T1};
+            const SmallSet<8> S2{T2};
+
+            assert(S1.is_inline() == (T1.cardinality() <= 8));
+            assert(S1.to_set() == T1 && S1.cardinality() == T1.cardinality());
+            assert((S1 + S2).to_set() == T1 + T2);
+            assert((S1 * S2).to_set() == T1 * T2);
+            assert((S1 - S2).to_set() == T1 - T2);
+            assert((S1 == S2) == (T1 == T2) && (S1 <=> S2) == (T1 <=> T2));
+            assert(((S1 * S2) <=> S1) == (Set{T1 * T2} <=> T1));
+            for (int val = -1; val <= 31; ++val) {
+                assert(S1.is_member(val) == T1.is_member(val));
+            }
+
+            SmallSet<8> S4{S1};
+            SmallSet<8> S5{std::move(S4)};
+            S4 = S5;
+            assert(S4 == S1 && S5 == S1);
+        }
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 26                                      *
+     * Range queries                                      *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 26: range queries\n";
+
+    {
+        std::vector<int> A;
+        for (int i = -3000; i < 3000; i += 3) A.push_back(i);
+        Set S1{A};
+        Set S2{A};
+        S2.enable_index();
+        const FlatSet F{A};
+
+        std::mt19937 gen{43};
+        std::uniform_int_distribution<int> dist{-3100, 3100};
+        for (int round = 0; round < 200; ++round) {
+            const int lo = dist(gen);
+            const int hi = (round % 10 == 0) ? lo - 1 : lo + dist(gen) / 10 + 50;
+            std::vector<int> expected;
+            std::copy_if(A.begin(), A.end(), std::back_inserter(expected),
+                         [&](int val) { return lo <= val && val <= hi; });
+
+            assert(S1.count_range(lo, hi) == expected.size() && S2.count_range(lo, hi) == expected.size());
+            assert(F.count_range(lo, hi) == expected.size());
+            assert(std::ranges::equal(S1.range(lo, hi), expected) && std::ranges::equal(S2.range(lo, hi), expected));
+            assert(std::ranges::equal(F.range(lo, hi), expected));
+        }
+
+        [[maybe_unused]] const int min = std::numeric_limits<int>::min();
+        [[maybe_unused]] const int max = std::numeric_limits<int>::max();
+        assert(S2.count_range(min, max) == A.size() && F.count_range(min, max) == A.size());
+        assert(S1.count_range(max, max) == 0 && S1.range(min, -3001).empty() && F.range(3000, max).empty());
+
+        // Test: the view points into the Set, and survives changes outside of it (33, its end, is kept)
+        [[maybe_unused]] auto view = S2.range(0, 30);
+        assert(std::ranges::distance(view) == 11 && *view.begin() == 0);
+        S2.insert(-1);
+        S2.erase(60);
+        assert(std::ranges::distance(view) == 11 && std::ranges::max(view) == 30);
+        int sum = 0;
+        for (int val : S2.range(-1, 3)) sum += val;
+        assert(sum == 2);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 27                                      *
+     * Batch membership                                   *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 27: batch membership\n";
+
+    {
+        std::vector<int> A;
+        for (int i = -5000; i < 5000; i += 7) A.push_back(i);
+        Set S1{A};
+        Set S2{A};
+        S2.enable_index();
+
+        std::mt19937 gen{44};
+        std::uniform_int_distribution<int> dist{-5100, 5100};
+        for (std::size_t m : {0, 1, 63, 64, 65, 1000}) {
+            std::vector<int> queries(m);
+            for (int& val : queries) val = dist(gen);
+            if (m > 0) queries[m / 2] = std::numeric_limits<int>::min();
+            if (m > 1) queries[m / 3] = std::numeric_limits<int>::max();
+            std::vector<int> sorted_queries{queries};
+            std::sort(sorted_queries.begin(), sorted_queries.end());
+
+            for (const std::vector<int>& Q : {queries, sorted_queries}) {
+                for (const Set* S : {&S1, &S2}) {
+                    std::vector<std::uint64_t> bitmap((m + 63) / 64 + 1, ~std::uint64_t{0});
+                    S->is_member(Q, bitmap);
+                    for (std::size_t i = 0; i < m; ++i) {
+                        assert(((bitmap[i / 64] >> (i % 64)) & 1) == S->is_member(Q[i]));
+                    }
+                    assert(m % 64 == 0 || (bitmap[m / 64] >> (m % 64)) == 0);  // unused bits cleared
+                    assert(bitmap.back() == ~std::uint64_t{0});  // words past the queries are untouched
+                }
+            }
+        }
+
+        // Test: repeated queries, and a small batch galloping through the express lanes
+        const std::vector<int> Q{40, 40, -5000, 4, 40, 4996};
+        std::uint64_t bitmap = 0;
+        S2.is_member(Q, std::span{&bitmap, 1});
+        assert(bitmap == 0b110111);
+        Set{}.is_member(Q, std::span{&bitmap, 1});
+        assert(bitmap == 0);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 28                                      *
+     * Parallel FlatSet operations                        *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 28: parallel FlatSet operations\n";
+
+    {
+        // Pairs of FlatSets large enough to be split into 5 segments:
+        // random overlap, equal sets, a subset, disjoint value ranges, and interleaved values
+        std::mt19937 gen{45};
+        std::uniform_int_distribution<int> dist{0, 600000};
+        std::vector<int> A1(200000), A2(200000);
+        for (int& val : A1) val = dist(gen);
+        for (int& val : A2) val = dist(gen);
+        const FlatSet F1 = FlatSet::from_unsorted(A1);
+        const FlatSet F2 = FlatSet::from_unsorted(A2);
+
+        std::vector<int> low, high, even, odd;
+        for (int i = 0; i < 200000; ++i) {
+            low.push_back(i);
+            high.push_back(200000 + i);
+            even.push_back(2 * i);
+            odd.push_back(2 * i + 1);
+        }
+
+        const std::vector<std::pair<FlatSet, FlatSet>> cases{
+            {F1, F2}, {F1, F1}, {F1, F1 * F2}, {FlatSet{low}, FlatSet{high}}, {FlatSet{high}, FlatSet{low}},
+            {FlatSet{even}, FlatSet{odd}}, {FlatSet{even}, FlatSet{}}, {FlatSet{}, FlatSet{odd}}};
+
+        for (const auto& [S1, S2] : cases) {
+            for (unsigned n_threads : {1u, 2u, 5u}) {
+                FlatSet U{S1}, I{S1}, D{S1};
+                U.unite(S2, n_threads);
+                I.intersect(S2, n_threads);
+                D.subtract(S2, n_threads);
+                assert(U == S1 + S2 && I == S1 * S2 && D == S1 - S2);
+            }
+        }
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 29                                      *
+     * Bloom filter                                       *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 29: Bloom filter\n";
+
+    {
+        // Test: a filtered Set answers as an unfiltered one, through all operations
+        std::mt19937 gen{46};
+        std::uniform_int_distribution<int> dist{0, 4000};
+        Set S1;
+        S1.enable_filter();
+        Set S2;  // same values, no filter
+        assert(S1.has_filter() && !S2.has_filter() && !S1.is_member(0));
+
+        auto check = [&]([[maybe_unused]] const Set& S) {
+            for (int val = -1; val <= 4001; val += 3) {
+                assert(S.is_member(val) == S2.is_member(val));
+                assert((S.find(val) == S.end()) == !S2.is_member(val));
+            }
+        };
+
+        for (int round = 0; round < 40; ++round) {
+            std::vector<int> A(100);
+            for (int& val : A) val = dist(gen);
+            const Set T = Set::from_unsorted(A);
+            switch (round % 6) {
+                case 0: S1 += T; S2 += T; break;
+                case 1: S1 *= T + S2 - 7; S2 *= T + S2 - 7; break;
+                case 2: S1 -= T; S2 -= T; break;
+                case 3: S1 ^= T; S2 ^= T; break;
+                case 4:
+                    for (int val : A) {
+                        S1.insert(val);
+                        S2.insert(val);
+                    }
+                    break;
+                default:
+                    for (int val : A) {
+                        S1.erase(val);
+                        S2.erase(val);
+                    }
+            }
+            assert(S1 == S2);
+            check(S1);
+        }
+
+        Set S3{std::move(S1)};
+        assert(S3.has_filter() && !S1.has_filter());
+        check(S3);
+        S3.make_empty();
+        assert(!S3.is_member(0) && S3.has_filter());
+        S3 = S2;
+        assert(!S3.has_filter());  // as the express lanes, the filter is not copied by assignment
+    }
+
+    {
+        // Test: lookups in a large filtered Set
+        std::vector<int> A;
+        for (int i = 0; i < 100000; ++i) A.push_back(2 * i);
+        Set S{A};
+        S.enable_filter();
+        S.is_member(0);  // build the filter
+
+        // Odd values are absent: the answers stay exact, whatever the false positives of the filter
+        for (int val = 1; val < 200000; val += 2) {
+            assert(!S.is_member(val) && S.find(val) == S.end());
+        }
+        assert(S.is_member(199998) && *S.find(4) == 4);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 30                                      *
+     * PackedSet: block-compressed 64-bit keys            *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 30: PackedSet\n";
+
+    {
+        // Test: small sets, printed as a Set
+        const PackedSet P1{std::vector<std::uint64_t>{1, 3, 5}};
+        const PackedSet P2 = PackedSet::from_unsorted({5, 2, 3, 2});
+        const PackedSet big{std::numeric_limits<std::uint64_t>::max()};
+
+        std::ostringstream os;
+        os << PackedSet{} << " " << P1 << " " << P1 + P2 << " " << P1 * P2 << " " << P1 - P2 << " " << (big + 0);
+        assert(os.str() == "Set is empty! { 1 3 5 } { 1 2 3 5 } { 3 5 } { 1 } { 0 18446744073709551615 }");
+
+        assert(P1.cardinality() == 3 && P1.is_member(3) && !P1.is_member(4) && !P1.is_member(0));
+        assert((P1 <=> P2) == std::partial_ordering::unordered);
+        assert(PackedSet{3} < P1 && P1 > PackedSet{5} && P1 <= P1 && !(PackedSet{4} < P1));
+        assert(PackedSet{} < P1 && PackedSet{} == PackedSet{});
+
+        PackedSet P3{P1};
+        P3 -= P1;
+        assert(P3.is_empty() && P3 == PackedSet{});
+        P3 += P2;
+        P3.make_empty();
+        assert(P3.is_empty() && !P3.is_member(2));
+    }
+
+    {
+        // Test: random sets of many blocks, with gaps of 1 to 2^52, against std::set
+        std::mt19937_64 gen{47};
+        auto make = [&](std::uint64_t max_gap, std::size_t n) {
+            std::uniform_int_distribution<std::uint64_t> gap{1, max_gap};
+            std::vector<std::uint64_t> keys;
+            std::uint64_t key = gap(gen) - 1;
+            for (std::size_t i = 0; i < n; ++i, key += gap(gen)) {
+                keys.push_back(key);
+            }
+            return keys;
+        };
+
+        for (std::uint64_t max_gap : {std::uint64_t{1}, std::uint64_t{3}, std::uint64_t{1000}, std::uint64_t{1} << 52}) {
+            const std::vector<std::uint64_t> A = make(max_gap, 2000);
+            std::vector<std::uint64_t> B = make(max_gap, 1500);
+            if (max_gap > 3) {  // share some keys with A
+                for (std::size_t i = 0; i < A.size(); i += 3) B.push_back(A[i]);
+            }
+            const PackedSet P1{A};
+            const PackedSet P2 = PackedSet::from_unsorted(B);
+            assert(P1.to_vector() == A && P1.cardinality() == A.size());
+
+            const std::set<std::uint64_t> S1(A.begin(), A.end());
+            const std::set<std::uint64_t> S2(B.begin(), B.end());
+            std::vector<std::uint64_t> U, I, D;
+            std::set_union(S1.begin(), S1.end(), S2.begin(), S2.end(), std::back_inserter(U));
+            std::set_intersection(S1.begin(), S1.end(), S2.begin(), S2.end(), std::back_inserter(I));
+            std::set_difference(S1.begin(), S1.end(), S2.begin(), S2.end(), std::back_inserter(D));
+
+            assert((P1 + P2).to_vector() == U && (P2 + P1) == PackedSet{U});
+            assert((P1 * P2).to_vector() == I && (P2 * P1) == PackedSet{I});
+            assert((P1 - P2).to_vector() == D);
+            assert(P1 * P2 <= P1 && P1 <= P1 + P2 && P1 - P2 < P1 + P2);
+
+            for ([[maybe_unused]] std::uint64_t key : B) {
+                assert(P1.is_member(key) == S1.contains(key));
+                assert(P1.is_member(key + 1) == S1.contains(key + 1));
+            }
+            for ([[maybe_unused]] std::uint64_t key : A) assert(P1.is_member(key));
+        }
+
+        // Consecutive keys are stored in the block headers only: less than 2 bits per key
+        std::vector<std::uint64_t> A(100000);
+        std::iota(A.begin(), A.end(), std::uint64_t{1} << 40);
+        assert(PackedSet{A}.encoded_bytes() < A.size() / 4);
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 31                                      *
+     * Reading Sets: operator>>                           *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 31: operator>>\n";
+
+    {
+        // Test: what operator<< writes, operator>> reads back
+        const std::vector<Set> sets{Set{}, Set{-7}, Set{std::vector<int>{std::numeric_limits<int>::min(), -1, 0, 3,
+                                                                        std::numeric_limits<int>::max()}},
+                                    Set::from_unsorted(std::vector<int>{9, 4, 1, 9})};
+        std::stringstream ss;
+        for (const Set& S : sets) ss << S << "\n";
+
+        for ([[maybe_unused]] const Set& S : sets) {
+            Set R{42};
+            assert(ss >> R && R == S && R.cardinality() == S.cardinality());
+        }
+        Set R{42};
+        assert(!(ss >> R) && R == Set{42});  // end of the stream
+
+        // Set written on more than 1 MB, read in several chunks, and values in any order
+        std::vector<int> A(300000);
+        std::iota(A.begin(), A.end(), -150000);
+        std::stringstream ss2;
+        ss2 << Set{A} << "{3 1\t3\n2}   { }";
+        Set S1, S2, S3;
+        assert(ss2 >> S1 >> S2 >> S3);
+        assert(S1.to_vector() == A && S2 == Set::from_unsorted(std::vector<int>{1, 2, 3}) && S3.is_empty());
+
+        // The express lanes and the filter of the Set read are kept
+        Set S4{7};
+        S4.enable_index();
+        S4.enable_filter();
+        std::istringstream is4{"{ 5 1 3 } Set is empty!"};
+        is4 >> S4;
+        assert(is4 && S4.has_index() && S4.has_filter() && S4.is_member(3) && !S4.is_member(7));
+        assert(S4.lower_bound(2) == 3 && S4.cardinality() == 3);
+        is4 >> S4;
+        assert(is4 && S4.has_index() && S4.has_filter() && S4.is_empty() && !S4.is_member(3));
+    }
+
+    {
+        // Test: format errors set the failbit and leave the Set unchanged
+        for (const char* text : {"", "  ", "Set is", "Set is full!", "{ 1 2", "{ 1 x }", "{ 1,2 }", "{ 1-2 }",
+                                 "{ 99999999999 }", "[ 1 ]", "1 2"}) {
+            std::istringstream is{text};
+            Set S{5};
+            is >> S;
+            assert(is.fail() && S == Set{5});
+        }
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 32                                      *
+     * CompactSet: list of 32-bit indices in an arena     *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 32: CompactSet\n";
+
+    {
+        // Test: operations, compared with class Set
+        std::mt19937 gen{48};
+        for (int round = 0; round < 40; ++round) {
+            std::uniform_int_distribution<int> dist{-500, 500};
+            std::vector<int> A1, A2;
+            for (int i = 0; i < 300; ++i) {
+                A1.push_back(dist(gen));
+                A2.push_back(dist(gen) / (1 + round % 3));
+            }
+            const Set S1 = Set::from_unsorted(A1);
+            const Set S2 = Set::from_unsorted(A2);
+            const CompactSet C1{S1};
+            const CompactSet C2{S2};
+
+            assert(C1.to_set() == S1 && C1.cardinality() == S1.cardinality());
+            assert((C1 + C2).to_set() == S1 + S2);
+            assert((C1 * C2).to_set() == S1 * S2);
+            assert((C1 - C2).to_set() == S1 - S2);
+            assert((C1 - C1).is_empty() && (C1 * C1) == C1 && (C1 + C1) == C1);
+            assert((C1 == C2) == (S1 == S2) && (C1 <=> C2) == (S1 <=> S2));
+            assert(((C1 * C2) <=> C1) == (Set{S1 * S2} <=> S1));
+            for (int val = -510; val <= 510; val += 3) {
+                assert(C1.is_member(val) == S1.is_member(val));
+            }
+        }
+
+        // Test: erased slots are reused by insertions
+        CompactSet C3;
+        for (int i = 0; i < 2000; ++i) {
+            const int val = (i * 7919) % 2000;  // all values in [0, 2000), in scrambled order
+            [[maybe_unused]] const bool inserted = C3.insert(val);
+            assert(inserted && !C3.insert(val));
+        }
+        assert(C3.cardinality() == 2000 && C3.get_count_slots() == 2002);
+        for (int val = 0; val < 2000; val += 2) {
+            assert(C3.erase(val) && !C3.erase(val));
+        }
+        for (int val = 2000; val < 3000; ++val) {
+            C3.insert(val);
+        }
+        assert(C3.cardinality() == 2000 && C3.get_count_slots() == 2002);
+
+        // Test: compaction keeps the values, in a smaller arena
+        std::vector<int> odd;
+        for (int val = 1; val < 2000; val += 2) odd.push_back(val);
+        odd.push_back(2000);
+        CompactSet C4{C3};
+        C4 -= CompactSet{odd};  // more than half of the slots become free
+        assert(C4.cardinality() == 999 && C4.get_count_slots() == 1001);
+        assert(C4.to_vector().front() == 2001 && C4.to_vector().back() == 2999);
+        C4.erase(2500);
+        C4.compact();
+        assert(C4.get_count_slots() == 1000 && !C4.is_member(2500) && C4.is_member(2501));
+
+        std::ostringstream os;
+        os << CompactSet{std::vector<int>{1, 2, 3}} << " " << CompactSet{};
+        assert(os.str() == "{ 1 2 3 } Set is empty!");
+
+        CompactSet C5{std::move(C4)};
+        assert(C4.is_empty() && C4.get_count_slots() == 2 && C5.cardinality() == 998);
+        C5.make_empty();
+        assert(C5.is_empty() && C5.get_count_slots() == 2 && C5.insert(7) && C5 == CompactSet{7});
+    }
+
+    assert(Set::get_count_nodes() == 0);
+    std::cout << "Success!!\n";
+
+    /*****************************************************
+     * TEST PHASE 33                                      *
+     * BufferedSet: write buffer for insertions           *
+     ******************************************************/
+    std::cout << "\nTEST PHASE 33: BufferedSet\n";
+
+    {
+        // Test: bursts of insertions, with repetitions, compared with class Set
+        std::mt19937 gen{49};
+        std::uniform_int_distribution<int> dist{-3000, 3000};
+        BufferedSet B;
+        Set S;
+        for (int burst = 0; burst < 20; ++burst) {
+            for (int i = 0; i < 500; ++i) {
+                const int val = dist(gen);
+                B.insert(val);
+                S.insert(val);
+            }
+            assert(B.buffered() <= std::max(BufferedSet::min_capacity, S.cardinality() / 4));
+            if (burst % 4 == 0) {
+                [[maybe_unused]] const int val = dist(gen);
+                assert(B.is_member(val) == S.is_member(val) && B.buffered() == 0);
+            }
+        }
+        assert(B.to_set() == S && B.cardinality() == S.cardinality() && B.view().hash() == S.hash());
+
+        // Bursts of increasing keys, each followed by a read
+        BufferedSet B1;
+        for (int val = 0; val < 20000; ++val) {
+            B1.insert(val);
+            if (val % 1000 == 999) {
+                assert(B1.is_member(val / 2) && !B1.is_member(val + 1) && B1.buffered() == 0);
+            }
+        }
+        assert(B1.cardinality() == 20000 && B1.view().lower_bound(-1) == 0 && B1.view().lower_bound(19999) == 19999);
+
+        // Reads merge the buffer
+        BufferedSet B2{S};
+        B2.insert(3001);
+        B2.insert(-3001);
+        B2.insert(3001);
+        assert(B2.buffered() == 3 && !B2.is_empty());
+        assert(B2 > B && (B <=> B2) == std::partial_ordering::less && B2.buffered() == 0);
+        assert(B2.cardinality() == S.cardinality() + 2 && B2.erase(3001) && !B2.erase(3001));
+
+        // += with small Sets appends to the buffer
+        BufferedSet B3;
+        for (int val = 100; val > 0; --val) {
+            B3 += BufferedSet{val};
+        }
+        assert(B3.buffered() == 100);
+        std::ostringstream os;
+        os << B3 * BufferedSet{std::vector<int>{2, 3, 200}} << " " << BufferedSet{} << " " << B3 - B3;
+        assert(os.str() == "{ 2 3 } Set is empty! Set is empty!");
+        assert((B3 + B3) == B3 && (B3 + B2).to_set() == B3.to_set() + B2.to_set());
+
+        B3.insert(500);
+        B3.make_empty();
+        assert(B3.is_empty() && B3.buffered() == 0 && B3.to_vector().empty());
+    }
+
     assert(Set::get_count_nodes() == 0);
     std::cout << "Success!!\n";
 }
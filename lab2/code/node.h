@@ -2,6 +2,8 @@
 
 #include <cassert>
 
+#include "settelemetry.h"
+
 /** Class Set::Node
  *
  * This class represents an internal node of a doubly linked list storing an int
@@ -19,15 +21,17 @@ public:
      */
     explicit Node(int nodeVal = 0, Node* nextPtr = nullptr, Node* prevPtr = nullptr)
         : value{nodeVal}, next{nextPtr}, prev{prevPtr} {
-        ++count_nodes;
+        ++*tally;
+        settelemetry::node_allocated(sizeof(Node));
     }
 
     /*
      * Destructor
      */
     ~Node() {
-        --count_nodes;
+        --*tally;
         assert(count_nodes >= 0);  // number of existing nodes can never be negative
+        settelemetry::node_freed(sizeof(Node));
     }
 
     /*
@@ -46,4 +50,8 @@ public:
     Node* prev;  // Pointer to the previous Node
 
     static int count_nodes;  // total number of existing nodes -- to help to detect bugs in the code
+
+    // Counter of the nodes created and deleted by this thread: count_nodes, except in the threads of
+    // Set::split_merge, which count their nodes locally and add them to count_nodes after the join
+    static thread_local int* tally;
 };
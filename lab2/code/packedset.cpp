@@ -0,0 +1,374 @@
+#include "packedset.h"
+
+#include <algorithm>
+#include <bit>
+
+/*****************************************************
+ * Bit packing                                        *
+ ******************************************************/
+
+namespace {
+
+/*
+ * Mask of the width lowest bits
+ */
+std::uint64_t low_bits(std::uint32_t width) {
+    return (width == 64) ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+}
+
+/*
+ * Read width bits at bit position pos of words
+ */
+std::uint64_t read_bits(const std::uint64_t* words, std::uint64_t pos, std::uint32_t width) {
+    const std::uint64_t* w = words + pos / 64;
+    const unsigned shift = pos % 64;
+    std::uint64_t x = w[0] >> shift;
+    if (shift + width > 64) {
+        x |= w[1] << (64 - shift);
+    }
+    return x & low_bits(width);
+}
+
+}  // namespace
+
+/*****************************************************
+ * Cursor and Builder                                 *
+ ******************************************************/
+
+/*
+ * Decodes the keys of a PackedSet in increasing order, one block at a time
+ */
+class PackedSet::Cursor {
+public:
+    explicit Cursor(const PackedSet& S) : S{S} {
+        load(0);
+    }
+
+    bool done() const {
+        return (b == S.blocks.size());
+    }
+
+    key_type value() const {
+        return keys[i];
+    }
+
+    void next() {
+        if (++i == count) {
+            load(b + 1);
+        }
+    }
+
+    /*
+     * Move to the first key larger than or equal to key
+     * The blocks whose successor starts at or before key are skipped without being decoded
+     */
+    void seek(key_type key) {
+        if (done() || keys[count - 1] >= key) {
+            while (!done() && keys[i] < key) next();
+            return;
+        }
+        std::size_t c = b + 1;
+        while (c + 1 < S.blocks.size() && S.blocks[c + 1].first <= key) {
+            ++c;
+        }
+        load(c);
+        while (!done() && keys[i] < key) next();
+    }
+
+private:
+    const PackedSet& S;
+    std::size_t b{0};      // current block
+    std::size_t i{0};      // position of the current key in the block
+    std::size_t count{0};  // number of keys in the current block
+    key_type keys[block_size];
+
+    void load(std::size_t block) {
+        b = block;
+        i = 0;
+        if (!done()) {
+            count = S.blocks[b].count;
+            S.decode(b, keys);
+        }
+    }
+};
+
+/*
+ * Encodes increasing keys into a new PackedSet, one block of block_size keys at a time
+ */
+class PackedSet::Builder {
+public:
+    void push_back(key_type key) {
+        keys[n++] = key;
+        if (n == block_size) {
+            flush();
+        }
+    }
+
+    /*
+     * Return the PackedSet with all keys pushed
+     */
+    PackedSet finish() {
+        flush();
+        return std::move(S);
+    }
+
+private:
+    PackedSet S;
+    std::size_t n{0};  // number of keys waiting to be encoded
+    key_type keys[block_size];
+
+    void flush() {
+        if (n == 0)
+            return;
+
+        std::uint64_t largest = 0;
+        for (std::size_t i = 1; i < n; ++i) {
+            largest = std::max(largest, keys[i] - keys[i - 1] - 1);
+        }
+        const std::uint32_t width = static_cast<std::uint32_t>(std::bit_width(largest));
+        const std::uint64_t first_word = S.words.size();
+        S.blocks.push_back(Block{keys[0], first_word, static_cast<std::uint32_t>(n), width});
+
+        S.words.resize(first_word + ((n - 1) * width + 63) / 64, 0);
+        std::uint64_t* words = S.words.data() + first_word;
+        std::uint64_t pos = 0;
+        for (std::size_t i = 1; i < n && width > 0; ++i, pos += width) {
+            const std::uint64_t delta = keys[i] - keys[i - 1] - 1;
+            const unsigned shift = pos % 64;
+            words[pos / 64] |= delta << shift;
+            if (shift + width > 64) {
+                words[pos / 64 + 1] |= delta >> (64 - shift);
+            }
+        }
+
+        S.counter += n;
+        n = 0;
+    }
+};
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ *  Conversion constructor: convert key into a singleton {key}
+ */
+PackedSet::PackedSet(key_type key) {
+    blocks.push_back(Block{key, 0, 1, 0});
+    counter = 1;
+}
+
+/*
+ * Constructor to create a PackedSet from a sorted vector of keys, without repetitions
+ */
+PackedSet::PackedSet(const std::vector<key_type>& list_of_keys) {
+    Builder builder;
+    for (key_type key : list_of_keys) {
+        builder.push_back(key);
+    }
+    *this = builder.finish();
+}
+
+/*
+ * Create a PackedSet from unsorted keys, possibly with repetitions
+ */
+PackedSet PackedSet::from_unsorted(std::vector<key_type> keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return PackedSet{keys};
+}
+
+/*
+ * Return a sorted vector with all keys in the PackedSet
+ */
+std::vector<PackedSet::key_type> PackedSet::to_vector() const {
+    std::vector<key_type> list_of_keys(counter);
+    std::size_t n = 0;
+    for (std::size_t b = 0; b < blocks.size(); ++b) {
+        decode(b, list_of_keys.data() + n);
+        n += blocks[b].count;
+    }
+    return list_of_keys;
+}
+
+/*
+ * Transform the PackedSet into an empty set
+ */
+void PackedSet::make_empty() {
+    blocks.clear();
+    words.clear();
+    counter = 0;
+}
+
+/*
+ * Test whether key belongs to the PackedSet
+ * Binary search of the last block whose first key is not larger than key, then decode that block
+ */
+bool PackedSet::is_member(key_type key) const {
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), key,
+                               [](key_type k, const Block& block) { return k < block.first; });
+    if (it == blocks.begin())
+        return false;
+    const Block& block = *(it - 1);
+    if (block.width == 0) {  // consecutive keys
+        return (key - block.first < block.count);
+    }
+
+    key_type x = block.first;
+    std::uint64_t pos = 0;
+    for (std::uint32_t i = 1; i < block.count && x < key; ++i, pos += block.width) {
+        x += read_bits(words.data() + block.word, pos, block.width) + 1;
+    }
+    return (x == key);
+}
+
+/*
+ * Number of bytes used by the encoded keys and the block headers
+ */
+size_t PackedSet::encoded_bytes() const {
+    return blocks.size() * sizeof(Block) + words.size() * sizeof(std::uint64_t);
+}
+
+/*
+ * Test whether *this and S represent the same set: the encodings are equal
+ */
+bool PackedSet::operator==(const PackedSet& S) const {
+    return (counter == S.counter && blocks == S.blocks && words == S.words);
+}
+
+/*
+ * Three-way comparison operator: set inclusion, as for class Set
+ */
+std::partial_ordering PackedSet::operator<=>(const PackedSet& S) const {
+    if (counter == S.counter) {
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+
+    const bool shorter = (counter < S.counter);
+    Cursor c_short{shorter ? *this : S};
+    Cursor c_long{shorter ? S : *this};
+    for (; !c_short.done(); c_short.next()) {
+        c_long.seek(c_short.value());
+        if (c_long.done() || c_long.value() != c_short.value())
+            return std::partial_ordering::unordered;
+    }
+    return shorter ? std::partial_ordering::less : std::partial_ordering::greater;
+}
+
+/*
+ * Modify *this such that it becomes the union of *this with S
+ */
+PackedSet& PackedSet::operator+=(const PackedSet& S) {
+    if (S.is_empty())
+        return *this;
+
+    Builder builder;
+    Cursor a{*this};
+    Cursor b{S};
+    while (!a.done() && !b.done()) {
+        if (a.value() < b.value()) {
+            builder.push_back(a.value());
+            a.next();
+        } else if (b.value() < a.value()) {
+            builder.push_back(b.value());
+            b.next();
+        } else {
+            builder.push_back(a.value());
+            a.next();
+            b.next();
+        }
+    }
+    for (; !a.done(); a.next()) {
+        builder.push_back(a.value());
+    }
+    for (; !b.done(); b.next()) {
+        builder.push_back(b.value());
+    }
+    *this = builder.finish();
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the intersection of *this with S
+ */
+PackedSet& PackedSet::operator*=(const PackedSet& S) {
+    filter(S, [](key_type key, Cursor& other) {
+        other.seek(key);
+        return (!other.done() && other.value() == key);
+    });
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the difference between *this and S
+ */
+PackedSet& PackedSet::operator-=(const PackedSet& S) {
+    filter(S, [](key_type key, Cursor& other) {
+        other.seek(key);
+        return (other.done() || other.value() != key);
+    });
+    return *this;
+}
+
+/*
+ * Write PackedSet *this to stream os, in the same format as a Set
+ */
+void PackedSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (Cursor c{*this}; !c.done(); c.next()) {
+            os << c.value() << " ";
+        }
+        os << "}";
+    }
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Decode block b into out
+ */
+void PackedSet::decode(std::size_t b, key_type* out) const {
+    const Block& block = blocks[b];
+    const std::uint64_t* packed = words.data() + block.word;
+    const std::uint64_t mask = low_bits(block.width);
+
+    key_type x = block.first;
+    out[0] = x;
+    if (block.width == 0) {  // consecutive keys
+        for (std::uint32_t i = 1; i < block.count; ++i) {
+            out[i] = ++x;
+        }
+        return;
+    }
+
+    std::uint64_t pos = 0;
+    for (std::uint32_t i = 1; i < block.count; ++i, pos += block.width) {
+        const unsigned shift = pos % 64;
+        std::uint64_t delta = packed[pos / 64] >> shift;
+        if (shift + block.width > 64) {
+            delta |= packed[pos / 64 + 1] << (64 - shift);
+        }
+        x += (delta & mask) + 1;
+        out[i] = x;
+    }
+}
+
+/*
+ * Keep the keys of *this for which keep(key, cursor over S) is true, encoding them into a new PackedSet
+ */
+template <typename Keep>
+void PackedSet::filter(const PackedSet& S, Keep keep) {
+    Builder builder;
+    Cursor other{S};
+    for (Cursor c{*this}; !c.done(); c.next()) {
+        if (keep(c.value(), other)) {
+            builder.push_back(c.value());
+        }
+    }
+    *this = builder.finish();
+}
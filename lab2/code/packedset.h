@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+
+/** Class to represent a set of 64-bit keys, compressed in blocks
+ *
+ * The sorted keys are split into blocks of block_size consecutive keys
+ * A block stores the differences between consecutive keys, minus 1 (frame of reference: the first key),
+ * bit-packed with the number of bits of the largest difference, in a shared array of 64-bit words
+ * The block headers (first key, position, number of keys and bit width) form a skip index:
+ * a lookup binary searches the headers, then decodes one block
+ *
+ * E.g. 10^6 random keys spread over 2^40 take about 3 bytes per key,
+ * instead of 8 bytes in a vector and 32 bytes per Node of class Set
+ *
+ * It has the same interface as class Set, for keys of type std::uint64_t
+ * +=, *= and -= decode both operands block by block while merging them and encode the result as it is produced,
+ * in linear time; *= and -= skip the blocks of S that cannot contain the current key, without decoding them
+ * The encoding of a set of keys is unique, so == compares the encoded arrays
+ */
+class PackedSet {
+public:
+    using key_type = std::uint64_t;
+
+    static constexpr std::size_t block_size = 128;
+
+    /*
+     *  Default constructor :create an empty PackedSet
+     */
+    PackedSet() = default;
+
+    /*
+     *  Conversion constructor: convert key into a singleton {key}
+     */
+    PackedSet(key_type key);
+
+    /*
+     * Constructor to create a PackedSet from a sorted vector of keys, without repetitions
+     */
+    explicit PackedSet(const std::vector<key_type>& list_of_keys);
+
+    /*
+     * Create a PackedSet from unsorted keys, possibly with repetitions
+     */
+    static PackedSet from_unsorted(std::vector<key_type> keys);
+
+    /*
+     * Return a sorted vector with all keys in the PackedSet
+     */
+    std::vector<key_type> to_vector() const;
+
+    /*
+     * Transform the PackedSet into an empty set
+     */
+    void make_empty();
+
+    /*
+     * Test whether key belongs to the PackedSet, in O(log(n / block_size) + block_size) time
+     */
+    bool is_member(key_type key) const;
+
+    bool is_empty() const {
+        return (counter == 0);
+    }
+
+    size_t cardinality() const {
+        return counter;
+    }
+
+    /*
+     * Number of bytes used by the encoded keys and the block headers
+     */
+    size_t encoded_bytes() const;
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const PackedSet& S) const;
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const PackedSet& S) const;
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     */
+    PackedSet& operator+=(const PackedSet& S);
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     */
+    PackedSet& operator*=(const PackedSet& S);
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     */
+    PackedSet& operator-=(const PackedSet& S);
+
+private:
+    /*
+     * Header of a block, in the skip index
+     */
+    struct Block {
+        key_type first;       // first key of the block
+        std::uint64_t word;   // position of the packed differences in words
+        std::uint32_t count;  // number of keys in the block
+        std::uint32_t width;  // number of bits per difference, 0 to 64
+
+        bool operator==(const Block&) const = default;
+    };
+
+    class Cursor;   // decodes the keys of a PackedSet, block after block
+    class Builder;  // encodes sorted keys into a PackedSet
+
+    std::vector<Block> blocks;
+    std::vector<std::uint64_t> words;  // bit-packed differences of all blocks
+    size_t counter{0};                 // number of keys in the PackedSet
+
+    /*
+     * Decode block b into out, which must have room for block_size keys
+     */
+    void decode(std::size_t b, key_type* out) const;
+
+    /*
+     * Keep the keys of *this for which keep(key, cursor over S) is true
+     * Used by *= and -=
+     */
+    template <typename Keep>
+    void filter(const PackedSet& S, Keep keep);
+
+    /*
+     * Write PackedSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    friend std::ostream& operator<<(std::ostream& os, const PackedSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    friend PackedSet operator+(PackedSet S1, const PackedSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend PackedSet operator*(PackedSet S1, const PackedSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend PackedSet operator-(PackedSet S1, const PackedSet& S2) {
+        return (S1 -= S2);
+    }
+};
@@ -0,0 +1,75 @@
+#include "parallelsort.h"
+
+#include <algorithm>
+#include <thread>
+
+/*
+ * Number of threads to use when n_threads == 0
+ */
+unsigned default_thread_count() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/*
+ * Sort values in increasing order and remove repeated values, using n_threads threads
+ */
+void parallel_sort_unique(std::vector<int>& values, unsigned n_threads) {
+    constexpr std::size_t min_slice = 1 << 16;  // smaller slices are not worth a thread
+
+    if (n_threads == 0) n_threads = default_thread_count();
+    std::size_t n_slices = std::min<std::size_t>(n_threads, values.size() / min_slice);
+
+    if (n_slices <= 1) {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+        return;
+    }
+
+    // Slice i is values[first[i], last[i]), after sorting and removing repetitions
+    std::vector<std::size_t> first(n_slices), last(n_slices);
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < n_slices; ++i) {
+            first[i] = values.size() * i / n_slices;
+            threads.emplace_back([&, i] {
+                auto begin = values.begin() + first[i];
+                auto end = values.begin() + values.size() * (i + 1) / n_slices;
+                std::sort(begin, end);
+                last[i] = static_cast<std::size_t>(std::unique(begin, end) - values.begin());
+            });
+        }
+    }  // join
+
+    // Merge rounds: slices 2k and 2k+1 are merged into buffer, then the buffers are swapped
+    std::vector<int> buffer(values.size());
+    while (n_slices > 1) {
+        const std::size_t n_merged = (n_slices + 1) / 2;
+        std::vector<std::size_t> merged_last(n_merged);
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t k = 0; k < n_merged; ++k) {
+                threads.emplace_back([&, k] {
+                    const std::size_t a = 2 * k;
+                    const std::size_t b = std::min(a + 1, n_slices - 1);
+                    auto out = buffer.begin() + first[a];
+                    if (a == b) {
+                        out = std::copy(values.begin() + first[a], values.begin() + last[a], out);
+                    } else {
+                        out = std::set_union(values.begin() + first[a], values.begin() + last[a],
+                                             values.begin() + first[b], values.begin() + last[b], out);
+                    }
+                    merged_last[k] = static_cast<std::size_t>(out - buffer.begin());
+                });
+            }
+        }  // join
+
+        for (std::size_t k = 0; k < n_merged; ++k) {
+            first[k] = first[2 * k];
+            last[k] = merged_last[k];
+        }
+        n_slices = n_merged;
+        values.swap(buffer);
+    }
+
+    values.resize(last[0]);
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+
+/*
+ * Sort values in increasing order and remove repeated values, using n_threads threads
+ * (n_threads == 0: one thread per hardware thread)
+ * values is split into one slice per thread, each slice is sorted and deduplicated,
+ * then the slices are merged pairwise with std::set_union, one round after another
+ */
+void parallel_sort_unique(std::vector<int>& values, unsigned n_threads = 0);
+
+/*
+ * Number of threads to use when n_threads == 0
+ */
+unsigned default_thread_count();
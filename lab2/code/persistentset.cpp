@@ -0,0 +1,346 @@
+#include "persistentset.h"
+#include "sethash.h"
+
+#include <utility>
+
+/*****************************************************
+ * Tree nodes and algorithms                          *
+ ******************************************************/
+
+/*
+ * Node of a treap: a binary search tree by value and a max-heap by priority
+ * Nodes are immutable once built
+ */
+struct PersistentSet::Node {
+    int value;
+    std::uint64_t priority;
+    size_t size;  // number of nodes in the subtree
+    Tree left;
+    Tree right;
+};
+
+class PersistentSet::TreeOps {
+public:
+    /*
+     * Priority of val: its hash (see sethash.h)
+     * Distinct values get distinct priorities, so the tree shape depends only on the set of values
+     */
+    static std::uint64_t priority_of(int val) {
+        return sethash::mix(val);
+    }
+
+    static size_t size(const Tree& t) {
+        return t ? t->size : 0;
+    }
+
+    static Tree make(int val, Tree left, Tree right) {
+        const size_t n = size(left) + size(right) + 1;
+        return std::make_shared<const Node>(Node{val, priority_of(val), n, std::move(left), std::move(right)});
+    }
+
+    /*
+     * Tree with the root value of t and subtrees left and right
+     * t itself is returned, if its subtrees are unchanged
+     */
+    static Tree rebuild(const Tree& t, Tree left, Tree right) {
+        if (left == t->left && right == t->right)
+            return t;
+        const size_t n = size(left) + size(right) + 1;
+        return std::make_shared<const Node>(Node{t->value, t->priority, n, std::move(left), std::move(right)});
+    }
+
+    /*
+     * Test whether the root of a has a higher priority than the root of b (an empty tree has the lowest)
+     */
+    static bool higher(const Tree& a, const Tree& b) {
+        if (!b)
+            return true;
+        return a && a->priority > b->priority;
+    }
+
+    static bool contains(const Node* t, int val) {
+        while (t) {
+            if (val == t->value)
+                return true;
+            t = (val < t->value) ? t->left.get() : t->right.get();
+        }
+        return false;
+    }
+
+    /*
+     * Split t into the values smaller than val and the values larger than val
+     */
+    struct Split {
+        Tree less;
+        bool found = false;
+        Tree greater;
+    };
+
+    static Split split(const Tree& t, int val) {
+        if (!t)
+            return {};
+        if (val < t->value) {
+            Split s = split(t->left, val);
+            s.greater = rebuild(t, std::move(s.greater), t->right);
+            return s;
+        }
+        if (t->value < val) {
+            Split s = split(t->right, val);
+            s.less = rebuild(t, t->left, std::move(s.less));
+            return s;
+        }
+        return {t->left, true, t->right};
+    }
+
+    /*
+     * Join trees l and r, all values of l being smaller than all values of r
+     */
+    static Tree join(const Tree& l, const Tree& r) {
+        if (!l)
+            return r;
+        if (!r)
+            return l;
+        if (higher(l, r))
+            return rebuild(l, l->left, join(l->right, r));
+        return rebuild(r, join(l, r->left), r->right);
+    }
+
+    /*
+     * Union: the operand with the highest priority root keeps its root,
+     * the other operand is split by the root value and its parts are merged with the subtrees
+     */
+    static Tree unite(Tree a, Tree b) {
+        if (!a || a == b)
+            return b;
+        if (!b)
+            return a;
+        if (higher(b, a))
+            std::swap(a, b);
+        Split s = split(b, a->value);
+        return rebuild(a, unite(a->left, std::move(s.less)), unite(a->right, std::move(s.greater)));
+    }
+
+    static Tree intersect(Tree a, Tree b) {
+        if (!a || !b)
+            return nullptr;
+        if (a == b)
+            return a;
+        if (higher(b, a))
+            std::swap(a, b);
+        Split s = split(b, a->value);
+        Tree l = intersect(a->left, std::move(s.less));
+        Tree r = intersect(a->right, std::move(s.greater));
+        return s.found ? rebuild(a, std::move(l), std::move(r)) : join(l, r);
+    }
+
+    static Tree subtract(const Tree& a, const Tree& b) {
+        if (!a || !b)
+            return a;
+        if (a == b)
+            return nullptr;
+        Split s = split(b, a->value);
+        Tree l = subtract(a->left, s.less);
+        Tree r = subtract(a->right, s.greater);
+        return s.found ? join(l, r) : rebuild(a, std::move(l), std::move(r));
+    }
+
+    /*
+     * Test whether trees a and b store the same values
+     * Since the shape of a tree depends only on its values, the trees are compared node by node
+     */
+    static bool equal(const Tree& a, const Tree& b) {
+        if (a == b)
+            return true;
+        if (!a || !b || a->size != b->size || a->value != b->value)
+            return false;
+        return equal(a->left, b->left) && equal(a->right, b->right);
+    }
+
+    /*
+     * Test whether all values of a belong to b
+     */
+    static bool subset(const Tree& a, const Tree& b) {
+        if (!a || a == b)
+            return true;
+        if (size(a) > size(b))
+            return false;
+        Split s = split(b, a->value);
+        return s.found && subset(a->left, s.less) && subset(a->right, s.greater);
+    }
+
+    /*
+     * Call f for each value of t, in increasing order
+     */
+    template <typename F>
+    static void for_each(const Node* t, F&& f) {
+        while (t) {
+            for_each(t->left.get(), f);
+            f(t->value);
+            t = t->right.get();
+        }
+    }
+
+    /*
+     * Build the tree of a sorted vector of values in linear time
+     * The shape (a Cartesian tree by priority) is found first with a stack of the nodes on the rightmost path,
+     * then the nodes are created bottom-up
+     */
+    static Tree build(const std::vector<int>& values) {
+        const std::size_t n = values.size();
+        constexpr std::size_t none = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> left(n, none), right(n, none);
+        std::vector<std::uint64_t> priority(n);
+        std::vector<std::size_t> path;
+
+        for (std::size_t i = 0; i < n; ++i) {
+            priority[i] = priority_of(values[i]);
+            std::size_t last = none;
+            while (!path.empty() && priority[path.back()] < priority[i]) {
+                last = path.back();
+                path.pop_back();
+            }
+            left[i] = last;
+            if (!path.empty())
+                right[path.back()] = i;
+            path.push_back(i);
+        }
+
+        auto make_subtree = [&](auto& self, std::size_t i) -> Tree {
+            if (i == none)
+                return nullptr;
+            Tree l = self(self, left[i]);
+            Tree r = self(self, right[i]);
+            const size_t size_i = size(l) + size(r) + 1;
+            return std::make_shared<const Node>(Node{values[i], priority[i], size_i, std::move(l), std::move(r)});
+        };
+        return path.empty() ? nullptr : make_subtree(make_subtree, path.front());
+    }
+};
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ *  Conversion constructor: convert val into a singleton {val}
+ */
+PersistentSet::PersistentSet(int val) : root{TreeOps::make(val, nullptr, nullptr)} {
+}
+
+/*
+ * Constructor to create a PersistentSet from a sorted vector of ints, in linear time
+ */
+PersistentSet::PersistentSet(const std::vector<int>& list_of_values) : root{TreeOps::build(list_of_values)} {
+}
+
+/*
+ * Constructor to create a PersistentSet with the same elements as Set S
+ */
+PersistentSet::PersistentSet(const Set& S) : PersistentSet{S.to_vector()} {
+}
+
+/*
+ * Return a Set with the same elements as the PersistentSet
+ */
+Set PersistentSet::to_set() const {
+    return Set{to_vector()};
+}
+
+/*
+ * Return a sorted vector with all ints in the PersistentSet
+ */
+std::vector<int> PersistentSet::to_vector() const {
+    std::vector<int> list_of_values;
+    list_of_values.reserve(cardinality());
+    TreeOps::for_each(root.get(), [&](int val) { list_of_values.push_back(val); });
+    return list_of_values;
+}
+
+/*
+ * Test whether val belongs to the PersistentSet
+ */
+bool PersistentSet::is_member(int val) const {
+    return TreeOps::contains(root.get(), val);
+}
+
+/*
+ * Add val to the PersistentSet
+ * Only the nodes on the path to val are copied
+ */
+void PersistentSet::insert(int val) {
+    if (!is_member(val))
+        root = TreeOps::unite(root, TreeOps::make(val, nullptr, nullptr));
+}
+
+/*
+ * Remove val from the PersistentSet
+ * Only the nodes on the path to val are copied
+ */
+void PersistentSet::erase(int val) {
+    if (is_member(val))
+        root = TreeOps::subtract(root, TreeOps::make(val, nullptr, nullptr));
+}
+
+/*
+ * Count the number of values stored in the PersistentSet
+ */
+size_t PersistentSet::cardinality() const {
+    return TreeOps::size(root);
+}
+
+/*
+ * Test whether *this and S represent the same set
+ */
+bool PersistentSet::operator==(const PersistentSet& S) const {
+    return TreeOps::equal(root, S.root);
+}
+
+/*
+ * Three-way comparison operator: set inclusion, as for class Set
+ */
+std::partial_ordering PersistentSet::operator<=>(const PersistentSet& S) const {
+    if (cardinality() == S.cardinality()) {
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+    if (cardinality() < S.cardinality()) {
+        return TreeOps::subset(root, S.root) ? std::partial_ordering::less : std::partial_ordering::unordered;
+    }
+    return TreeOps::subset(S.root, root) ? std::partial_ordering::greater : std::partial_ordering::unordered;
+}
+
+/*
+ * Modify *this such that it becomes the union of *this with S
+ */
+PersistentSet& PersistentSet::operator+=(const PersistentSet& S) {
+    root = TreeOps::unite(root, S.root);
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the intersection of *this with S
+ */
+PersistentSet& PersistentSet::operator*=(const PersistentSet& S) {
+    root = TreeOps::intersect(root, S.root);
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the difference between *this and S
+ */
+PersistentSet& PersistentSet::operator-=(const PersistentSet& S) {
+    root = TreeOps::subtract(root, S.root);
+    return *this;
+}
+
+/*
+ * Write PersistentSet *this to stream os, in the same format as a Set
+ */
+void PersistentSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        TreeOps::for_each(root.get(), [&](int val) { os << val << " "; });
+        os << "}";
+    }
+}
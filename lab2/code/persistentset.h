@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+
+#include "set.h"
+
+/** Class to represent an immutable, structurally shared Set of ints
+ *
+ * PersistentSet is implemented as a treap (a binary search tree that is a heap by node priority)
+ * whose nodes are never modified once built and are shared by all PersistentSets that contain them
+ * The priority of a node is a hash of its value, so a set of values has exactly one tree shape
+ *
+ * Copying a PersistentSet takes O(1) time and memory: the copy shares the root of the tree
+ * Modifying a PersistentSet copies only the O(log n) nodes on the paths to the modified values,
+ * all copies taken before (snapshots) keep their values
+ * Union, intersection and difference split and join trees, reusing the subtrees that do not change,
+ * and return right away when both operands share the same subtree
+ *
+ * It has the same interface as class Set, with expected time complexities
+ *   is_member, insert, erase:  O(log n)
+ *   +=, *=, -=, <=>:           O(m log(n / m + 1)), m <= n being the sizes of the operands
+ */
+class PersistentSet {
+public:
+    /*
+     *  Default constructor :create an empty PersistentSet
+     */
+    PersistentSet() = default;
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    PersistentSet(int val);
+
+    /*
+     * Constructor to create a PersistentSet from a sorted vector of ints, in linear time
+     */
+    explicit PersistentSet(const std::vector<int>& list_of_values);
+
+    /*
+     * Constructor to create a PersistentSet with the same elements as Set S
+     */
+    explicit PersistentSet(const Set& S);
+
+    /*
+     * Return a Set with the same elements as the PersistentSet
+     */
+    Set to_set() const;
+
+    /*
+     * Return a sorted vector with all ints in the PersistentSet
+     */
+    std::vector<int> to_vector() const;
+
+    /*
+     * Transform the PersistentSet into an empty set
+     */
+    void make_empty() {
+        root.reset();
+    }
+
+    /*
+     * Test whether val belongs to the PersistentSet
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Add val to the PersistentSet
+     */
+    void insert(int val);
+
+    /*
+     * Remove val from the PersistentSet
+     */
+    void erase(int val);
+
+    /*
+     * Test whether the PersistentSet is empty
+     */
+    bool is_empty() const {
+        return (root == nullptr);
+    }
+
+    /*
+     * Count the number of values stored in the PersistentSet
+     */
+    size_t cardinality() const;
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const PersistentSet& S) const;
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const PersistentSet& S) const;
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     */
+    PersistentSet& operator+=(const PersistentSet& S);
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     */
+    PersistentSet& operator*=(const PersistentSet& S);
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     */
+    PersistentSet& operator-=(const PersistentSet& S);
+
+private:
+    struct Node;
+    class TreeOps;  // algorithms on trees, defined in persistentset.cpp
+
+    using Tree = std::shared_ptr<const Node>;
+
+    Tree root;  // nullptr for an empty set
+
+    /*
+     * Write PersistentSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    friend std::ostream& operator<<(std::ostream& os, const PersistentSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    friend PersistentSet operator+(PersistentSet S1, const PersistentSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend PersistentSet operator*(PersistentSet S1, const PersistentSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend PersistentSet operator-(PersistentSet S1, const PersistentSet& S2) {
+        return (S1 -= S2);
+    }
+};
@@ -1,7 +1,20 @@
 #include "set.h"
 #include "node.h"
+#include "setindex.h"
+#include "setfilter.h"
+#include "sethash.h"
+#include "parallelsort.h"
+
+#include <cctype>
+#include <charconv>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <thread>
 
 int Set::Node::count_nodes = 0;
+thread_local int* Set::Node::tally = &Set::Node::count_nodes;
 
 /*****************************************************
  * Implementation of the member functions             *
@@ -33,6 +46,7 @@ Set::Set(int val) : Set{} {  // create an empty list
  * Create a Set with all ints in sorted vector list_of_values
  */
 Set::Set(const std::vector<int>& list_of_values) : Set{} {  // create an empty list
+    const settelemetry::Timer timer{settelemetry::Operation::construct};
     auto itr = list_of_values.begin();
     Node* ptr = head;
     while (itr != list_of_values.end()) {
@@ -42,12 +56,108 @@ Set::Set(const std::vector<int>& list_of_values) : Set{} {  // create an empty l
     }
 }
 
+/*
+ * Create a Set from unsorted ints, possibly with repetitions
+ * The values are sorted and repetitions removed in parallel, then the list is built in one pass
+ */
+Set Set::from_unsorted(std::vector<int> values) {
+    parallel_sort_unique(values);
+    return Set{values};
+}
+
+/*
+ * Create a Set from a text file of whitespace separated ints, unsorted and possibly with repetitions
+ * The whole file is read at once and parsed with std::from_chars
+ * Return an empty Set, if the file cannot be read
+ */
+Set Set::from_file(const std::filesystem::path& file) {
+    std::ifstream is(file, std::ios::binary);
+    if (!is) {
+        return Set{};
+    }
+
+    std::string text(std::filesystem::file_size(file), '\0');
+    is.read(text.data(), static_cast<std::streamsize>(text.size()));
+    text.resize(static_cast<size_t>(is.gcount()));
+
+    std::vector<int> values;
+    values.reserve(text.size() / 8);
+
+    const char* ptr = text.data();
+    const char* end = ptr + text.size();
+    while (true) {
+        while (ptr != end && std::isspace(static_cast<unsigned char>(*ptr))) ++ptr;
+        if (ptr == end) break;
+
+        int val = 0;
+        auto [next, ec] = std::from_chars(ptr, end, val);
+        if (ec != std::errc{}) break;  // not an int: stop reading, as operator>> does
+        values.push_back(val);
+        ptr = next;
+    }
+    return from_unsorted(std::move(values));
+}
+
+/*
+ * Union of all Sets in sets, computed in one pass by a k-way merge of the lists
+ * The slices are split by the values of the largest Set
+ */
+Set Set::union_all(std::span<const Set> sets, unsigned n_threads) {
+    if (sets.empty()) {
+        return Set{};
+    }
+    std::vector<const Set*> operands;
+    operands.reserve(sets.size());
+    for (const Set& S : sets) {
+        operands.push_back(&S);
+    }
+    const Set* largest = *std::max_element(operands.begin(), operands.end(), [](const Set* S1, const Set* S2) {
+        return S1->counter < S2->counter;
+    });
+
+    return split_merge(operands, largest, n_threads,
+                       [](const std::vector<Node*>& first, const std::vector<Node*>& last) {
+                           return union_slice(first, last);
+                       });
+}
+
+/*
+ * Intersection of all Sets in sets, computed in one pass
+ * The values of the smallest Set are looked up in the other Sets, by increasing cardinality
+ * The slices are split by the values of the smallest Set
+ */
+Set Set::intersect_all(std::span<const Set> sets, unsigned n_threads) {
+    if (sets.empty()) {
+        return Set{};
+    }
+    std::vector<const Set*> operands;
+    operands.reserve(sets.size());
+    for (const Set& S : sets) {
+        operands.push_back(&S);
+    }
+    std::stable_sort(operands.begin(), operands.end(), [](const Set* S1, const Set* S2) {
+        return S1->counter < S2->counter;
+    });
+
+    // Decided before starting the threads, since the express lanes may have to be rebuilt
+    std::vector<char> galloping(operands.size(), 0);
+    for (std::size_t i = 1; i < operands.size(); ++i) {
+        galloping[i] = operands[i]->prepare_gallop(operands[0]->counter);
+    }
+
+    return split_merge(operands, operands[0], n_threads,
+                       [&](const std::vector<Node*>& first, const std::vector<Node*>& last) {
+                           return intersect_slice(operands, first, last, galloping);
+                       });
+}
+
 /*
  * Copy constructor: create a new Set as a copy of Set S
  * \param S Set to copied
  * Function does not modify Set S in any way
  */
 Set::Set(const Set& S) : Set{} {  // create an empty list
+    const settelemetry::Timer timer{settelemetry::Operation::copy};
     Node* p_other = S.head;
     Node* p_this = head;
     while ((p_other = p_other->next) != S.tail) {
@@ -56,16 +166,109 @@ Set::Set(const Set& S) : Set{} {  // create an empty list
     }
 }
 
+/*
+ * Move constructor: create a new Set by stealing the nodes of Set S
+ * \param S Set to be moved, S becomes an empty Set
+ */
+Set::Set(Set&& S) : Set{} {  // create an empty list
+    std::swap(head, S.head);
+    std::swap(tail, S.tail);
+    std::swap(counter, S.counter);
+    std::swap(fingerprint, S.fingerprint);
+    std::swap(index, S.index);
+    std::swap(filter, S.filter);
+}
+
+/*
+ * Return a sorted vector with all ints in the Set
+ * This function does not modify the Set in any way
+ */
+std::vector<int> Set::to_vector() const {
+    std::vector<int> list_of_values;
+    list_of_values.reserve(counter);
+    for (Node* ptr = head->next; ptr != tail; ptr = ptr->next) {
+        list_of_values.push_back(ptr->value);
+    }
+    return list_of_values;
+}
+
+/*
+ * Return an iterator to val, or end() if val does not belong to the Set
+ */
+Set::const_iterator Set::find(int val) const {
+    if (filtered_out(val))
+        return end();
+    Node* ptr = seek(val);
+    if (ptr != tail && ptr->value != val)
+        ptr = tail;
+    return const_iterator{ptr};
+}
+
+/*
+ * Add val to the Set
+ * Return an iterator to val and whether val was inserted
+ */
+std::pair<Set::const_iterator, bool> Set::insert(int val) {
+    const settelemetry::Timer timer{settelemetry::Operation::insert};
+    Node* ptr = seek(val);
+    if (ptr != tail && ptr->value == val)
+        return {const_iterator{ptr}, false};
+    insert_node(ptr->prev, val);
+    return {const_iterator{ptr->prev}, true};
+}
+
+/*
+ * Add val to the Set, right before position hint, if that keeps the Set sorted
+ * Return an iterator to val
+ */
+Set::const_iterator Set::insert(const_iterator hint, int val) {
+    Node* ptr = hint.ptr;
+    if ((ptr == tail || val < ptr->value) && (ptr->prev == head || ptr->prev->value < val)) {
+        insert_node(ptr->prev, val);  // the hint is right: no search
+        return const_iterator{ptr->prev};
+    }
+    if (ptr != tail && ptr->value == val)
+        return hint;
+    return insert(val).first;
+}
+
+/*
+ * Remove val from the Set
+ * Return the number of values removed (0 or 1)
+ */
+size_t Set::erase(int val) {
+    const settelemetry::Timer timer{settelemetry::Operation::erase};
+    Node* ptr = seek(val);
+    if (ptr == tail || ptr->value != val)
+        return 0;
+    remove_node(ptr);
+    return 1;
+}
+
+/*
+ * Remove the value at position pos
+ * Return an iterator to the value after it
+ */
+Set::const_iterator Set::erase(const_iterator pos) {
+    Node* next = pos.ptr->next;
+    remove_node(pos.ptr);
+    return const_iterator{next};
+}
+
 /*
  * Transform the Set into an empty set
  * Remove all nodes from the list, except the dummy nodes
  */
 void Set::make_empty() {
+    const settelemetry::Timer timer{settelemetry::Operation::make_empty};
+    if (index) index->invalidate();
+    if (filter) filter->invalidate();
     Node* ptr = head->next;
     while (ptr = ptr->next) {
         remove_node(ptr->prev);
     }
     counter = 0;
+    fingerprint = 0;
     head->next = tail;
     tail->prev = head;
 }
@@ -77,6 +280,8 @@ Set::~Set() {
     make_empty();
     delete head;
     delete tail;
+    delete index;
+    delete filter;
 }
 
 /*
@@ -88,6 +293,9 @@ Set& Set::operator=(Set S) {
     std::swap(head, S.head);
     std::swap(tail, S.tail);
     counter = S.counter;
+    fingerprint = S.fingerprint;
+    std::swap(index, S.index);
+    std::swap(filter, S.filter);
     return *this;
 }
 
@@ -97,13 +305,118 @@ Set& Set::operator=(Set S) {
  * This function does not modify the Set in any way
  */
 bool Set::is_member(int val) const {
-    Node* ptr = head;
-    while((ptr = ptr->next) != tail && ptr->value <= val)
-    {
-        if (ptr->value == val)
-            return true;
+    const settelemetry::Timer timer{settelemetry::Operation::is_member};
+    if (filtered_out(val))
+        return false;
+    Node* ptr = seek(val);
+    return (ptr != tail && ptr->value == val);
+}
+
+/*
+ * Test whether each value of queries belongs to the Set, writing the answers to bitmap
+ * The queries are visited in increasing order: directly if they are sorted,
+ * otherwise through keys (value, position) sorted as 64-bit integers
+ */
+void Set::is_member(std::span<const int> queries, std::span<std::uint64_t> bitmap) const {
+    const settelemetry::Timer timer{settelemetry::Operation::is_member_batch};
+    const std::size_t m = queries.size();
+    assert(bitmap.size() >= (m + 63) / 64);
+    std::fill(bitmap.begin(), bitmap.begin() + (m + 63) / 64, 0);
+
+    // Answer the queries value(0) <= value(1) <= ... <= value(m - 1), stored at position(k) in queries
+    auto walk = [&](auto value, auto position) {
+        if (prepare_gallop(m)) {
+            std::size_t finger = 0;
+            for (std::size_t k = 0; k < m; ++k) {
+                const Node* ptr = gallop(finger, value(k));
+                if (ptr != tail && ptr->value == value(k))
+                    bitmap[position(k) / 64] |= std::uint64_t{1} << (position(k) % 64);
+            }
+            return;
+        }
+        const Node* ptr = head->next;
+        for (std::size_t k = 0; k < m; ++k) {
+            const int val = value(k);
+            while (ptr != tail && ptr->value < val) {
+                ptr = ptr->next;
+            }
+            if (ptr != tail && ptr->value == val)
+                bitmap[position(k) / 64] |= std::uint64_t{1} << (position(k) % 64);
+        }
+    };
+
+    if (std::is_sorted(queries.begin(), queries.end())) {
+        walk([&](std::size_t k) { return queries[k]; }, [](std::size_t k) { return k; });
+        return;
+    }
+
+    assert(m <= std::numeric_limits<std::uint32_t>::max());
+    std::vector<std::uint64_t> keys(m);  // biased value in the high half, so that keys sort as the values
+    for (std::size_t i = 0; i < m; ++i) {
+        keys[i] = (std::uint64_t{static_cast<std::uint32_t>(queries[i]) ^ 0x80000000u} << 32) | i;
     }
-    return false;
+    std::sort(keys.begin(), keys.end());
+    walk([&](std::size_t k) { return static_cast<int>(static_cast<std::uint32_t>(keys[k] >> 32) ^ 0x80000000u); },
+         [&](std::size_t k) { return static_cast<std::size_t>(keys[k] & 0xffffffffu); });
+}
+
+/*
+ * Return the smallest value in the Set that is larger than or equal to val
+ * Return std::nullopt, if there is no such value
+ * This function does not modify the Set in any way
+ */
+std::optional<int> Set::lower_bound(int val) const {
+    Node* ptr = seek(val);
+    if (ptr == tail)
+        return std::nullopt;
+    return ptr->value;
+}
+
+/*
+ * Attach a blocked Bloom filter to the Set
+ * The filter is built by the first lookup
+ */
+void Set::enable_filter() {
+    if (!filter)
+        filter = new Filter{};
+}
+
+/*
+ * Remove the Bloom filter, if any
+ */
+void Set::disable_filter() {
+    delete filter;
+    filter = nullptr;
+}
+
+/*
+ * Count the values in [lo, hi]
+ */
+size_t Set::count_range(int lo, int hi) const {
+    size_t count = 0;
+    if (lo <= hi) {
+        for (Node* ptr = seek(lo); ptr != tail && ptr->value <= hi; ptr = ptr->next) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/*
+ * Add skip-list express lanes on top of the list
+ * The lanes are built by the first seek
+ */
+void Set::enable_index() {
+    if (!index)
+        index = new Index{};
+}
+
+/*
+ * Remove the express lanes, if any
+ */
+void Set::disable_index() {
+    delete index;
+    index = nullptr;
 }
 
 /*
@@ -112,7 +425,8 @@ bool Set::is_member(int val) const {
  * Return false, otherwise
  */
 bool Set::operator==(const Set& S) const {
-    if (counter != S.counter)
+    const settelemetry::Timer timer{settelemetry::Operation::equal};
+    if (counter != S.counter || fingerprint != S.fingerprint)
         return false;
     Node* p_this = head->next;
     Node* p_other = S.head->next;
@@ -132,6 +446,7 @@ bool Set::operator==(const Set& S) const {
  * Return std::partial_ordering::unordered, otherwise
  */
 std::partial_ordering Set::operator<=>(const Set& S) const {
+    const settelemetry::Timer timer{settelemetry::Operation::compare};
 
     //Check if equal
     if (counter == S.counter) {
@@ -140,17 +455,30 @@ std::partial_ordering Set::operator<=>(const Set& S) const {
         return std::partial_ordering::unordered;
     }
 
-    Node* p_short = S.head->next;
-    Node* p_short_tail = S.tail;
-    Node* p_long = head->next;
-    Node* p_long_tail = tail;
+    const Set* s_short = &S;
+    const Set* s_long = this;
 
     // Check which set is shorter
     if (counter < S.counter) {
-        std::swap(p_short, p_long);
-        std::swap(p_short_tail, p_long_tail);
+        std::swap(s_short, s_long);
     }
 
+    // Skewed sizes: look up each value of the short set in the long one
+    if (s_long->prepare_gallop(s_short->counter)) {
+        std::size_t finger = 0;
+        for (Node* p = s_short->head->next; p != s_short->tail; p = p->next) {
+            Node* q = s_long->gallop(finger, p->value);
+            if (q == s_long->tail || q->value != p->value)
+                return std::partial_ordering::unordered;
+        }
+        return (counter < S.counter) ? std::partial_ordering::less : std::partial_ordering::greater;
+    }
+
+    Node* p_short = s_short->head->next;
+    Node* p_short_tail = s_short->tail;
+    Node* p_long = s_long->head->next;
+    Node* p_long_tail = s_long->tail;
+
     while (p_short != p_short_tail && p_long != p_long_tail) {
         if (p_short->value == p_long->value) {
             p_short = p_short->next;
@@ -172,11 +500,51 @@ std::partial_ordering Set::operator<=>(const Set& S) const {
     return std::partial_ordering::unordered;
 }
 
+/*
+ * Size of the intersection of Set *this and Set S
+ */
+size_t Set::intersection_size(const Set& S) const {
+    return count_common(S, std::numeric_limits<size_t>::max());
+}
+
+/*
+ * Size of the union of Set *this and Set S
+ */
+size_t Set::union_size(const Set& S) const {
+    return counter + S.counter - intersection_size(S);
+}
+
+/*
+ * Size of the difference between Set *this and Set S
+ */
+size_t Set::difference_size(const Set& S) const {
+    return counter - intersection_size(S);
+}
+
+/*
+ * Jaccard similarity of Set *this and Set S: |*this * S| / |*this + S|
+ * Two empty Sets are identical, i.e. their similarity is 1.0
+ */
+double Set::jaccard(const Set& S) const {
+    if (is_empty() && S.is_empty())
+        return 1.0;
+    const size_t common = intersection_size(S);
+    return static_cast<double>(common) / static_cast<double>(counter + S.counter - common);
+}
+
+/*
+ * Test whether Set *this and Set S have at least one common value
+ */
+bool Set::intersects(const Set& S) const {
+    return count_common(S, 1) > 0;
+}
+
 /*
  * Modify Set *this such that it becomes the union of *this with Set S
  * Set *this is modified and then returned
  */
 Set& Set::operator+=(const Set& S) {
+    const settelemetry::Timer timer{settelemetry::Operation::unite};
     Node* p_this = head->next;
     Node* p_other = S.head->next;
 
@@ -205,6 +573,22 @@ Set& Set::operator+=(const Set& S) {
  * Set *this is modified and then returned
  */
 Set& Set::operator*=(const Set& S) {
+    const settelemetry::Timer timer{settelemetry::Operation::intersect};
+    if (filter) filter->invalidate();  // rebuilt by the next lookup, without the bits of the removed values
+    // *this much smaller than S: keep the values found by galloping through S
+    if (S.prepare_gallop(counter)) {
+        std::size_t finger = 0;
+        Node* p_this = head->next;
+        while (p_this != tail) {
+            Node* q = S.gallop(finger, p_this->value);
+            p_this = p_this->next;
+            if (q == S.tail || q->value != p_this->prev->value)
+                remove_node(p_this->prev);
+        }
+        return *this;
+    }
+
+    if (index) index->invalidate();  // many nodes may be removed
     Node* p_this = head->next;
     Node* p_other = S.head->next;
 
@@ -234,6 +618,38 @@ Set& Set::operator*=(const Set& S) {
  * Set *this is modified and then returned
  */
 Set& Set::operator-=(const Set& S) {
+    const settelemetry::Timer timer{settelemetry::Operation::subtract};
+    if (filter) filter->invalidate();  // rebuilt by the next lookup, without the bits of the removed values
+    // *this much smaller than S: remove the values found by galloping through S
+    if (S.prepare_gallop(counter)) {
+        std::size_t finger = 0;
+        Node* p_this = head->next;
+        while (p_this != tail) {
+            Node* q = S.gallop(finger, p_this->value);
+            p_this = p_this->next;
+            if (q != S.tail && q->value == p_this->prev->value)
+                remove_node(p_this->prev);
+        }
+        return *this;
+    }
+
+    // S much smaller than *this: find the nodes to remove by galloping through *this
+    // They are removed afterwards, since removing nodes may invalidate the express lanes
+    if (prepare_gallop(S.counter)) {
+        std::vector<Node*> found;
+        std::size_t finger = 0;
+        for (Node* p = S.head->next; p != S.tail; p = p->next) {
+            Node* q = gallop(finger, p->value);
+            if (q != tail && q->value == p->value)
+                found.push_back(q);
+        }
+        for (Node* q : found) {
+            remove_node(q);
+        }
+        return *this;
+    }
+
+    if (index) index->invalidate();  // many nodes may be removed
     Node* p_this = head->next;
     Node* p_other = S.head->next;
 
@@ -253,11 +669,34 @@ Set& Set::operator-=(const Set& S) {
     return *this;
 }
 
+/*
+ * Modify Set *this such that it becomes the symmetric difference of Set *this and Set S
+ * Set *this is modified and then returned
+ */
+Set& Set::operator^=(const Set& S) {
+    // The fused expression is evaluated into a new Set, which is then swapped into *this
+    // The express lanes and the filter of *this are kept, to be rebuilt for the new list
+    Set result{*this ^ S};
+    if (index) index->invalidate();
+    if (filter) filter->invalidate();
+    std::swap(index, result.index);
+    std::swap(filter, result.filter);
+    return (*this = std::move(result));
+}
+
 
 /* ******************************************** *
  * Private Member Functions -- Implementation   *
  * ******************************************** */
 
+/*
+ * Hash of one value (see sethash.h)
+ * The hashes of the values are summed, so the fingerprint does not depend on the order of insertions
+ */
+std::uint64_t Set::value_hash(int val) {
+    return sethash::mix(val);
+}
+
 /*
  * Insert a new Node storing val after the Node pointed by p
  * \param p pointer to a Node
@@ -270,6 +709,9 @@ void Set::insert_node(Node* p, int val) {
     //Set p->next->prev to the new node then set p->next the the same
     p->next = p->next->prev = new Node(val, p->next, p);
     counter++;
+    fingerprint += value_hash(val);
+    if (index) index->node_inserted(p->next, tail);
+    if (filter) filter->node_inserted(val);
 }
 
 /*
@@ -279,14 +721,346 @@ void Set::insert_node(Node* p, int val) {
 void Set::remove_node(Node* p) {
     if (p == nullptr || p == head || p == tail)
         return;
+    if (index) index->node_removed(p, head);
+    if (filter) filter->node_removed();
     //Relink the list
     p->next->prev = p->prev;
     p->prev->next = p->next;
+    fingerprint -= value_hash(p->value);
     //Delete p
     delete p;
     counter--;
 }
 
+/*
+ * Number of values common to Set *this and Set S, counting stops once limit values are found
+ * The smaller Set is galloped through the larger one, if the larger one has valid express lanes,
+ * otherwise the lists are merged in lockstep
+ * It never rebuilds the lanes: the early exit at limit may make the merge much cheaper than a rebuild
+ */
+size_t Set::count_common(const Set& S, size_t limit) const {
+    const Set* s_short = (counter <= S.counter) ? this : &S;
+    const Set* s_long = (counter <= S.counter) ? &S : this;
+    size_t common = 0;
+
+    if (s_long->index && s_long->index->is_valid() && s_long->counter / gallop_ratio > s_short->counter) {
+        std::size_t finger = 0;
+        for (Node* p = s_short->head->next; p != s_short->tail && common < limit; p = p->next) {
+            Node* q = s_long->gallop(finger, p->value);
+            if (q == s_long->tail)
+                break;
+            if (q->value == p->value)
+                ++common;
+        }
+        return common;
+    }
+
+    Node* p_short = s_short->head->next;
+    Node* p_long = s_long->head->next;
+    while (p_short != s_short->tail && p_long != s_long->tail && common < limit) {
+        if (p_short->value == p_long->value) {
+            ++common;
+            p_short = p_short->next;
+            p_long = p_long->next;
+        }
+        else if (p_short->value < p_long->value) {
+            p_short = p_short->next;
+        }
+        else {
+            p_long = p_long->next;
+        }
+    }
+    return common;
+}
+
+/*
+ * Move all nodes of S to the end of the list, S becomes an empty Set
+ * All values of S must be larger than the values of *this
+ */
+void Set::splice_back(Set& S) {
+    if (S.is_empty())
+        return;
+    if (index) index->invalidate();
+    if (S.index) S.index->invalidate();
+    if (filter) filter->invalidate();
+    if (S.filter) S.filter->invalidate();
+
+    Node* first = S.head->next;
+    Node* last = S.tail->prev;
+    first->prev = tail->prev;
+    tail->prev->next = first;
+    last->next = tail;
+    tail->prev = last;
+    counter += S.counter;
+    fingerprint += S.fingerprint;
+
+    S.head->next = S.tail;
+    S.tail->prev = S.head;
+    S.counter = 0;
+    S.fingerprint = 0;
+}
+
+/*
+ * Union of the lists [first[i], last[i]), by a k-way merge
+ * The merge uses a loser tree: leaf k + i stands for list i, and each inner node j stores the list
+ * that lost the match between the winners of its children 2j and 2j + 1, i.e. the one with the larger current value
+ * After the overall winner advances, it replays only the matches on the path from its leaf to the root,
+ * one comparison per level
+ * The current values are cached in key, where an exhausted list has a key larger than any int
+ */
+Set Set::union_slice(const std::vector<Node*>& first, const std::vector<Node*>& last) {
+    constexpr long long exhausted = std::numeric_limits<long long>::max();
+    const std::size_t k = first.size();
+    std::vector<Node*> cur{first};
+    std::vector<long long> key(k);
+    for (std::size_t i = 0; i < k; ++i) {
+        key[i] = (cur[i] == last[i]) ? exhausted : cur[i]->value;
+    }
+
+    // Play all matches bottom-up, winner[j] is the list that won at node j
+    std::vector<std::size_t> loser(k);
+    std::size_t champion = 0;
+    {
+        std::vector<std::size_t> winner(2 * k);
+        for (std::size_t i = 0; i < k; ++i) {
+            winner[k + i] = i;
+        }
+        for (std::size_t j = k - 1; j > 0; --j) {
+            const std::size_t a = winner[2 * j];
+            const std::size_t b = winner[2 * j + 1];
+            winner[j] = (key[b] < key[a]) ? b : a;
+            loser[j] = (key[b] < key[a]) ? a : b;
+        }
+        champion = winner[1];  // k == 1: the only leaf is node 1
+    }
+
+    Set result;
+    Node* p_result = result.head;
+    while (key[champion] != exhausted) {
+        const int val = cur[champion]->value;
+        if (p_result == result.head || p_result->value != val) {  // skip repetitions
+            result.insert_node(p_result, val);
+            p_result = p_result->next;
+        }
+        cur[champion] = cur[champion]->next;
+        key[champion] = (cur[champion] == last[champion]) ? exhausted : cur[champion]->value;
+
+        for (std::size_t j = (k + champion) / 2; j > 0; j /= 2) {
+            if (key[loser[j]] < key[champion]) {
+                std::swap(loser[j], champion);
+            }
+        }
+    }
+    return result;
+}
+
+/*
+ * Intersection of the lists [first[i], last[i]) of sets[i], sets ordered by increasing cardinality
+ * galloping[i] != 0: look up the values in sets[i] by galloping, instead of walking its list
+ */
+Set Set::intersect_slice(const std::vector<const Set*>& sets, const std::vector<Node*>& first,
+                         const std::vector<Node*>& last, const std::vector<char>& galloping) {
+    std::vector<Node*> cur{first};
+    std::vector<std::size_t> finger(sets.size(), 0);
+
+    Set result;
+    for (Node* p = first[0]; p != last[0]; p = p->next) {
+        const int val = p->value;
+        bool found = true;
+        for (std::size_t i = 1; found && i < sets.size(); ++i) {
+            Node* q;
+            if (galloping[i]) {
+                q = sets[i]->gallop(finger[i], val);
+                if (q == sets[i]->tail)
+                    return result;  // no more values in sets[i]
+            } else {
+                q = cur[i];
+                while (q != last[i] && q->value < val) {
+                    q = q->next;
+                }
+                cur[i] = q;
+                if (q == last[i])
+                    return result;  // no more values of the slice in sets[i]
+            }
+            found = (q->value == val);
+        }
+        if (found) {
+            result.insert_node(result.tail->prev, val);
+        }
+    }
+    return result;
+}
+
+/*
+ * Split the value domain of sets into slices with about the same number of values of Set *pivots,
+ * call merge(first, last) for each slice in its own thread, and link the results together
+ * Slice s holds the values in [pivot[s - 1], pivot[s]), where pivot[s] is the value of *pivots
+ * at position s * |*pivots| / n_slices
+ */
+template <typename Merge>
+Set Set::split_merge(const std::vector<const Set*>& sets, const Set* pivots, unsigned n_threads, Merge merge) {
+    constexpr std::size_t min_slice = 1 << 14;  // smaller slices are not worth a thread
+
+    if (n_threads == 0) n_threads = default_thread_count();
+    const std::size_t n_slices = std::max<std::size_t>(1, std::min<std::size_t>(n_threads, pivots->counter / min_slice));
+
+    if (n_slices == 1) {
+        std::vector<Node*> first, last;
+        for (const Set* S : sets) {
+            first.push_back(S->head->next);
+            last.push_back(S->tail);
+        }
+        return merge(first, last);
+    }
+
+    std::vector<int> pivot;
+    {
+        Node* p = pivots->head->next;
+        std::size_t pos = 0;
+        for (std::size_t s = 1; s < n_slices; ++s) {
+            for (; pos < pivots->counter * s / n_slices; ++pos) {
+                p = p->next;
+            }
+            pivot.push_back(p->value);
+        }
+    }
+
+    // bounds[i][s] is the first node of sets[i] in slice s, bounds[i][n_slices] is the tail
+    // Indexed Sets seek the bounds, the other Sets are walked once
+    std::vector<std::vector<Node*>> bounds(sets.size());
+    auto find_bounds = [&](std::size_t i) {
+        const Set* S = sets[i];
+        std::vector<Node*>& b = bounds[i];
+        b.push_back(S->head->next);
+        Node* p = S->head->next;
+        for (int val : pivot) {
+            if (S->index && S->index->is_valid()) {
+                p = S->index->predecessor(S->head, val)->next;  // no seek: it may split a gap, and sets may repeat
+            }
+            while (p != S->tail && p->value < val) {
+                p = p->next;
+            }
+            b.push_back(p);
+        }
+        b.push_back(S->tail);
+    };
+
+    std::vector<Set> parts(n_slices);
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t t = 0; t < n_slices; ++t) {
+            threads.emplace_back([&, t] {
+                for (std::size_t i = t; i < sets.size(); i += n_slices) {
+                    find_bounds(i);
+                }
+            });
+        }
+    }  // join
+    std::vector<int> created(n_slices, 0);  // nodes created minus nodes deleted by each thread
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t s = 0; s < n_slices; ++s) {
+            threads.emplace_back([&, s] {
+                int count = 0;
+                Node::tally = &count;
+                std::vector<Node*> first, last;
+                for (const std::vector<Node*>& b : bounds) {
+                    first.push_back(b[s]);
+                    last.push_back(b[s + 1]);
+                }
+                parts[s] = merge(first, last);
+                created[s] = count;
+            });
+        }
+    }  // join
+    for (int count : created) {
+        Node::count_nodes += count;
+    }
+
+    Set result;
+    for (Set& part : parts) {
+        result.splice_back(part);
+    }
+    return result;
+}
+
+/*
+ * Return a pointer to the first Node storing a value larger than or equal to val
+ * Return tail, if there is no such Node
+ */
+Set::Node* Set::seek(int val) const {
+    Node* ptr = head;
+    if (index) {
+        if (!index->is_valid())
+            index->build(head, tail);
+        ptr = index->predecessor(head, val);
+    }
+    // ptr->value < val (or ptr is the head), walk the list to the lower bound
+    Node* const from = ptr;
+    std::size_t walked = 0;
+    do {
+        ptr = ptr->next;
+        ++walked;
+    } while (ptr != tail && ptr->value < val);
+
+    if (index && walked > Index::max_gap)  // many Nodes were inserted in this gap of lane 0
+        index->split_gap(from, head, tail);
+    return ptr;
+}
+
+/*
+ * Test whether the Bloom filter, if any, proves that val does not belong to the Set
+ */
+bool Set::filtered_out(int val) const {
+    if (!filter)
+        return false;
+    if (!filter->is_valid())
+        filter->build(head, tail, counter);
+    return !filter->may_contain(val);
+}
+
+/*
+ * Return the first Node with a value in [lo, hi] and the Node after the last one
+ */
+std::pair<Set::Node*, Set::Node*> Set::range_bounds(int lo, int hi) const {
+    if (hi < lo)
+        return {tail, tail};
+    Node* first = seek(lo);
+    Node* last = first;
+    while (last != tail && last->value <= hi) {
+        last = last->next;
+    }
+    return {first, last};
+}
+
+/*
+ * Test whether k lookups in *this are better done by galloping through the express lanes
+ * than by a linear merge, i.e. the Set has express lanes and is much larger than k
+ * The express lanes are rebuilt, if needed
+ */
+bool Set::prepare_gallop(std::size_t k) const {
+    if (!index || counter / gallop_ratio <= k)
+        return false;
+    if (!index->is_valid())
+        index->build(head, tail);
+    return true;
+}
+
+/*
+ * Return a pointer to the first Node storing a value larger than or equal to val
+ * Return tail, if there is no such Node
+ * \param finger position in the express lanes, updated by each call
+ * Successive calls must be done for increasing values of val, starting with finger == 0
+ */
+Set::Node* Set::gallop(std::size_t& finger, int val) const {
+    finger = index->gallop(finger, val);
+    Node* ptr = index->node_at(finger, head);
+    do {
+        ptr = ptr->next;
+    } while (ptr != tail && ptr->value < val);
+    return ptr;
+}
+
 /*
  * Write Set *this to stream os
  */
@@ -304,3 +1078,97 @@ void Set::write_to_stream(std::ostream& os) const {
         os << "}";
     }
 }
+
+/*
+ * Read a Set from stream is, in the format written by write_to_stream
+ * The text is read in chunks of up to 1 MB, up to the closing brace, and each chunk is parsed with std::from_chars
+ * A value cut at the end of a chunk is moved to the start of the next one
+ * Increasing values are appended to the list as they are parsed, without intermediate vector
+ */
+void Set::read_from_stream(std::istream& is) {
+    std::istream::sentry sentry{is};  // skip leading whitespace
+    if (!sentry) {
+        return;
+    }
+
+    if (is.peek() != '{') {
+        for (char c : std::string_view{"Set is empty!"}) {
+            if (is.get() != c) {
+                is.setstate(std::ios::failbit);
+                return;
+            }
+        }
+        make_empty();  // the express lanes and the filter are kept
+        return;
+    }
+    is.get();
+
+    // The values are appended to the list of R as long as they are increasing
+    // The other values are collected in unsorted, and added at the end
+    Set R;
+    std::vector<int> unsorted;
+
+    // Parse the whitespace separated ints of [ptr, end), return false on a format error
+    auto parse = [&](const char* ptr, const char* end) {
+        while (true) {
+            while (ptr != end && std::isspace(static_cast<unsigned char>(*ptr))) ++ptr;
+            if (ptr == end) return true;
+
+            int val = 0;
+            auto [next, ec] = std::from_chars(ptr, end, val);
+            if (ec != std::errc{} || (next != end && !std::isspace(static_cast<unsigned char>(*next)))) {
+                return false;
+            }
+            if (unsorted.empty() && (R.is_empty() || R.tail->prev->value < val)) {
+                R.insert_node(R.tail->prev, val);
+            } else {
+                unsorted.push_back(val);
+            }
+            ptr = next;
+        }
+    };
+
+    constexpr std::size_t chunk_size = 1 << 20;
+    constexpr std::size_t max_carry = 16;  // longer than any int
+    std::vector<char> chunk(chunk_size + max_carry + 1);
+    std::size_t carry = 0;  // characters of a cut value, at the start of chunk
+
+    while (true) {
+        is.getline(chunk.data() + carry, static_cast<std::streamsize>(chunk_size + 1), '}');
+        if (is.eof()) {  // no closing brace
+            is.setstate(std::ios::failbit);
+            return;
+        }
+
+        const char* begin = chunk.data();
+        if (!is.fail()) {  // the closing brace was read, and counted by gcount
+            if (!parse(begin, begin + carry + static_cast<std::size_t>(is.gcount()) - 1)) {
+                is.setstate(std::ios::failbit);
+                return;
+            }
+            break;
+        }
+        is.clear();  // getline sets the failbit when the chunk is full
+        const std::size_t length = carry + static_cast<std::size_t>(is.gcount());
+
+        // The chunk is full: parse it up to its last whitespace, and carry the rest over
+        const char* end = begin + length;
+        while (end != begin && !std::isspace(static_cast<unsigned char>(end[-1]))) --end;
+        carry = static_cast<std::size_t>(begin + length - end);
+        if (carry > max_carry || !parse(begin, end)) {
+            is.setstate(std::ios::failbit);
+            return;
+        }
+        std::copy(end, begin + length, chunk.data());
+    }
+
+    if (!unsorted.empty()) {
+        R += from_unsorted(std::move(unsorted));
+    }
+    // As for ^=, the express lanes and the filter of *this are kept, to be rebuilt for the new list
+    if (index) index->invalidate();
+    if (filter) filter->invalidate();
+    std::swap(index, R.index);
+    std::swap(filter, R.filter);
+    *this = std::move(R);
+}
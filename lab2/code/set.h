@@ -2,7 +2,38 @@
 
 #include <iostream>
 #include <vector>
+#include <optional>
 #include <compare>  // three-way comparison operator <=>
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <filesystem>
+#include <span>
+#include <cstdint>
+#include <functional>
+
+class Set;
+
+/*
+ * Lazy Set expressions, defined in setexpr.h
+ * Only what class Set needs to know about them is declared here
+ */
+namespace set_expr {
+class SetCursor;
+
+template <template <typename, typename> class OpCursor, typename L, typename R>
+class Expr;
+
+template <typename T>
+inline constexpr bool is_expr = false;
+
+template <template <typename, typename> class OpCursor, typename L, typename R>
+inline constexpr bool is_expr<Expr<OpCursor, L, R>> = true;
+
+template <typename T>
+concept Expression = is_expr<std::remove_cvref_t<T>>;
+}  // namespace set_expr
 
 /** Class to represent a Set of ints
  *
@@ -15,6 +46,13 @@
 class Set {
 
 public:
+    class const_iterator;  // bidirectional iterator over the values, in increasing order (see setiterator.h)
+
+    // Values cannot be modified through an iterator, since the list must stay sorted
+    using iterator = const_iterator;
+    using value_type = int;
+    using size_type = size_t;
+
     /*
      *  Default constructor :create an empty Set
      */
@@ -31,6 +69,55 @@ public:
      */
     explicit Set(const std::vector<int>& list_of_values);
 
+    /*
+     * Create a Set from unsorted ints, possibly with repetitions
+     * The values are sorted and repetitions removed in parallel (see parallelsort.h),
+     * then the list is built in one pass
+     */
+    static Set from_unsorted(std::vector<int> values);
+
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_value_t<R>, int>
+    static Set from_unsorted(R&& values) {
+        std::vector<int> V;
+        if constexpr (std::ranges::sized_range<R>) {
+            V.reserve(std::ranges::size(values));
+        }
+        std::ranges::copy(values, std::back_inserter(V));
+        return from_unsorted(std::move(V));
+    }
+
+    template <std::input_iterator It, std::sentinel_for<It> S>
+    static Set from_unsorted(It first, S last) {
+        return from_unsorted(std::ranges::subrange(first, last));
+    }
+
+    /*
+     * Create a Set from a text file of whitespace separated ints, unsorted and possibly with repetitions
+     * Return an empty Set, if the file cannot be read
+     */
+    static Set from_file(const std::filesystem::path& file);
+
+    /*
+     * Union of all Sets in sets, computed in one pass by a k-way merge of the lists
+     * A tournament tree selects the smallest current value of the k lists in O(log k) time,
+     * instead of the k - 1 passes (and intermediate Sets) of applying operator+= pairwise
+     * \param n_threads number of threads (0: one per hardware thread)
+     * With several threads, the value domain is split into slices with about the same number of values
+     * and each slice of the result is merged by its own thread
+     */
+    static Set union_all(std::span<const Set> sets, unsigned n_threads = 1);
+
+    /*
+     * Intersection of all Sets in sets, computed in one pass
+     * Each value of the smallest Set is looked up in the other Sets, from the smallest to the largest,
+     * until it is missing in one of them, and the merge stops as soon as one Set is exhausted
+     * Indexed Sets much larger than the smallest one are galloped through (see enable_index)
+     * The intersection of no Sets is the empty Set
+     * \param n_threads number of threads, as for union_all
+     */
+    static Set intersect_all(std::span<const Set> sets, unsigned n_threads = 1);
+
     /*
      * Copy constructor: create a new Set as a copy of Set S
      * \param S Set to copied
@@ -38,6 +125,64 @@ public:
      */
     Set(const Set& S);
 
+    /*
+     * Move constructor: create a new Set by stealing the nodes of Set S
+     * \param S Set to be moved, S becomes an empty Set
+     */
+    Set(Set&& S);
+
+    /*
+     * Conversion constructor: evaluate a lazy Set expression, e.g. (S1 + S2) * S3 - S4
+     * All operand lists are merged simultaneously in one pass
+     * and each node of the new Set is created exactly once
+     */
+    template <set_expr::Expression E>
+    Set(const E& expr);
+
+    /*
+     * Return a sorted vector with all ints in the Set
+     * This function does not modify the Set in any way
+     */
+    std::vector<int> to_vector() const;
+
+    /*
+     * Iterators to the first value and past the last value of the Set
+     */
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    /*
+     * Return an iterator to val, or end() if val does not belong to the Set
+     * The express lanes are used, if the Set has them
+     */
+    const_iterator find(int val) const;
+
+    /*
+     * Add val to the Set
+     * Return an iterator to val and whether val was inserted (false, if it already belonged to the Set)
+     */
+    std::pair<const_iterator, bool> insert(int val);
+
+    /*
+     * Add val to the Set, right before position hint, if that keeps the Set sorted
+     * Then, it takes O(1) time: e.g. appending increasing values with hint end(), as std::inserter does
+     * Otherwise, val is inserted as by insert(val)
+     * Return an iterator to val
+     */
+    const_iterator insert(const_iterator hint, int val);
+
+    /*
+     * Remove val from the Set
+     * Return the number of values removed (0 or 1)
+     */
+    size_t erase(int val);
+
+    /*
+     * Remove the value at position pos, in O(1) time
+     * Return an iterator to the value after it
+     */
+    const_iterator erase(const_iterator pos);
+
     /*
      * Transform the Set into an empty set
      * Remove all nodes from the list, except the dummy nodes
@@ -63,6 +208,85 @@ public:
      */
     bool is_member(int val) const;
 
+    /*
+     * Test whether each value of queries belongs to the Set
+     * Bit i % 64 of bitmap[i / 64] is set to 1, if queries[i] belongs to the Set, and to 0 otherwise
+     * bitmap must have at least (queries.size() + 63) / 64 words
+     * All queries are answered in one walk through the list, in O(n + m) time for m sorted queries
+     * Unsorted queries are sorted first, in O(m log m) time
+     * If the Set has express lanes and m is much smaller than n, the walk gallops through the lanes instead
+     */
+    void is_member(std::span<const int> queries, std::span<std::uint64_t> bitmap) const;
+
+    /*
+     * Return the smallest value in the Set that is larger than or equal to val
+     * Return std::nullopt, if there is no such value
+     * This function does not modify the Set in any way
+     */
+    std::optional<int> lower_bound(int val) const;
+
+    /*
+     * Return a view of the values in [lo, hi], in increasing order
+     * The view points into the Set, no value is copied, and it stays valid until one of its values is removed,
+     * or the first value larger than hi, which its end iterator points to
+     * It takes O(log n + k) time with express lanes, k being the number of values in [lo, hi], O(n) otherwise
+     * Return type: std::ranges::subrange<const_iterator>, defined in setiterator.h
+     */
+    auto range(int lo, int hi) const;
+
+    /*
+     * Count the values in [lo, hi], in the same time as range(lo, hi)
+     */
+    size_t count_range(int lo, int hi) const;
+
+    /*
+     * Add skip-list express lanes on top of the list
+     * Then, is_member and lower_bound take O(log n) time, instead of O(n)
+     * Moreover, *=, -= and <=> with a much smaller Set S gallop through the lanes
+     * in O(|S| log n) time, instead of a linear merge
+     * Values inserted after the last value extend the lanes; values inserted elsewhere are reached by a walk
+     * from the lanes, and a lookup that walks more than a few Nodes adds that part of the list to the lanes
+     * Lanes invalidated by removals or by many insertions are rebuilt in linear time by the next lookup
+     * Copies of the Set are not indexed
+     * Since const lookups update the lanes (and the Bloom filter, see enable_filter), an indexed or filtered Set
+     * must not be read by several threads at the same time
+     */
+    void enable_index();
+
+    /*
+     * Remove the express lanes, if any
+     */
+    void disable_index();
+
+    /*
+     * Test whether the Set has express lanes
+     */
+    bool has_index() const {
+        return (index != nullptr);
+    }
+
+    /*
+     * Attach a blocked Bloom filter to the Set (see setfilter.h)
+     * Then, is_member and find answer most lookups of absent values in O(1) time, reading one cache line,
+     * instead of walking the list
+     * The filter is kept up to date by all Set operations (lazily rebuilt in linear time after bulk removals)
+     * The rebuild is done by a const lookup: a filtered Set must not be read by several threads at the same time
+     * Copies of the Set have no filter
+     */
+    void enable_filter();
+
+    /*
+     * Remove the Bloom filter, if any
+     */
+    void disable_filter();
+
+    /*
+     * Test whether the Set has a Bloom filter
+     */
+    bool has_filter() const {
+        return (filter != nullptr);
+    }
+
     /*
      * Test whether the Set is empty
      * Return true if the set is empty, otherwise false
@@ -81,6 +305,16 @@ public:
         return counter;
     }
 
+    /*
+     * Order-independent 64-bit hash of the values in the Set
+     * It is the sum of a hash of each value, kept up to date when nodes are inserted or removed,
+     * so it is returned in O(1) time
+     * Equal Sets have equal hashes, so Sets with different hashes are rejected by == in O(1) time
+     */
+    std::uint64_t hash() const {
+        return fingerprint;
+    }
+
     /*
      * Test whether Set *this and S represent the same set
      * Return true, if *this has same elemnts as set S
@@ -97,6 +331,27 @@ public:
      */
     std::partial_ordering operator<=>(const Set& S) const;
 
+    /*
+     * Sizes of the intersection, union and difference of Set *this and Set S, and their Jaccard similarity
+     * |*this * S| / |*this + S| (1.0, if both Sets are empty)
+     * The lists are merged without building the resulting Set, i.e. no nodes are allocated
+     * A much smaller Set is galloped through a Set with express lanes, as for operator*=
+     * These functions do not modify the Sets in any way
+     */
+    size_t intersection_size(const Set& S) const;
+    size_t union_size(const Set& S) const;
+    size_t difference_size(const Set& S) const;
+    double jaccard(const Set& S) const;
+
+    /*
+     * Test whether Set *this and Set S have at least one common value (intersects),
+     * or none (is_disjoint), stopping at the first common value
+     */
+    bool intersects(const Set& S) const;
+    bool is_disjoint(const Set& S) const {
+        return !intersects(S);
+    }
+
     /*
      * Modify Set *this such that it becomes the union of *this with Set S
      * Set *this is modified and then returned
@@ -115,6 +370,13 @@ public:
      */
     Set& operator-=(const Set& S);
 
+    /*
+     * Modify Set *this such that it becomes the symmetric difference of Set *this and Set S
+     * i.e. the Set of elements that belong to exactly one of the two sets
+     * Set *this is modified and then returned
+     */
+    Set& operator^=(const Set& S);
+
     /*
      * Return number of existing nodes
      * Used solely for debug purposes
@@ -122,16 +384,29 @@ public:
     static int get_count_nodes();
 
 private:
-    class Node;  // nested class defined in node.h
+    class Node;   // nested class defined in node.h
+    class Index;  // nested class defined in setindex.h
+    class Filter; // nested class defined in setfilter.h
+
+    friend class set_expr::SetCursor;  // walks the list when evaluating lazy expressions
 
     Node* head;      // pointer to the dummy header Node
     Node* tail;      // pointer to the dummy tail Node
     size_t counter;  // number of values in the Set
+    std::uint64_t fingerprint{0};  // sum of value_hash of all values in the Set
+
+    mutable Index* index{nullptr};  // optional express lanes, rebuilt on demand by const functions
+    mutable Filter* filter{nullptr};  // optional Bloom filter, rebuilt on demand by const functions
 
     /* ************************** *
      * Private Member Functions    *
      * **************************  */
 
+    /*
+     * Hash of one value, summed into fingerprint
+     */
+    static std::uint64_t value_hash(int val);
+
     /*
      * Insert a new Node storing val after the Node pointed by p
      * \param p pointer to a Node
@@ -145,11 +420,84 @@ private:
      */
     void remove_node(Node* p);
 
+    /*
+     * Number of values common to Set *this and Set S, counting stops once limit values are found
+     */
+    size_t count_common(const Set& S, size_t limit) const;
+
+    /*
+     * Move all nodes of S to the end of the list, S becomes an empty Set
+     * All values of S must be larger than the values of *this
+     */
+    void splice_back(Set& S);
+
+    /*
+     * Union of the lists [first[i], last[i]), by a k-way merge
+     */
+    static Set union_slice(const std::vector<Node*>& first, const std::vector<Node*>& last);
+
+    /*
+     * Intersection of the lists [first[i], last[i]) of sets[i], sets ordered by increasing cardinality
+     * galloping[i] != 0: look up the values in sets[i] by galloping, instead of walking its list
+     */
+    static Set intersect_slice(const std::vector<const Set*>& sets, const std::vector<Node*>& first,
+                               const std::vector<Node*>& last, const std::vector<char>& galloping);
+
+    /*
+     * Split the value domain of sets into slices with about the same number of values of Set *pivots,
+     * call merge(first, last) for each slice in its own thread, and link the results together
+     * first[i] and last[i] delimit the nodes of sets[i] in the slice
+     */
+    template <typename Merge>
+    static Set split_merge(const std::vector<const Set*>& sets, const Set* pivots, unsigned n_threads,
+                           Merge merge);
+
+    /*
+     * Return a pointer to the first Node storing a value larger than or equal to val
+     * Return tail, if there is no such Node
+     * The express lanes are used, if the Set has them
+     */
+    Node* seek(int val) const;
+
+    /*
+     * Return the first Node with a value in [lo, hi] and the Node after the last one
+     * Both are the same Node, if there is no value in [lo, hi]
+     */
+    std::pair<Node*, Node*> range_bounds(int lo, int hi) const;
+
+    /*
+     * Test whether the Bloom filter, if any, proves that val does not belong to the Set
+     */
+    bool filtered_out(int val) const;
+
+    /*
+     * Galloping lookups are used when one Set has express lanes
+     * and is at least gallop_ratio times larger than the other Set
+     */
+    static constexpr std::size_t gallop_ratio = 32;
+
+    /*
+     * Test whether k lookups in *this should be done by galloping through the express lanes
+     */
+    bool prepare_gallop(std::size_t k) const;
+
+    /*
+     * Return a pointer to the first Node storing a value larger than or equal to val (or tail)
+     * \param finger position in the express lanes, updated by each call
+     * Successive calls must be done for increasing values of val, starting with finger == 0
+     */
+    Node* gallop(std::size_t& finger, int val) const;
+
     /*
      * Write Set *this to stream os
      */
     void write_to_stream(std::ostream& os) const;
 
+    /*
+     * Read a Set from stream is, in the format written by write_to_stream
+     */
+    void read_from_stream(std::istream& is);
+
     /* ******************************************* *
      * Overloaded operators: non-member functions  *
      * ******************************************* */
@@ -164,29 +512,32 @@ private:
     }
 
     /*
-     * Overloaded operator+: Set union S1+S2
-     * S1+S2 is the Set of elements in Set S1 or in Set S2 (without repeated elements)
-     * Return a new Set representing the union of S1 with S2, S1+S2
+     * Overloaded operator>>: read "Set is empty!" or "{ a b c }", as written by operator<<
+     * The values are parsed with std::from_chars and appended to a new list while they increase
+     * Values out of order or repeated are accepted, and sorted as by from_unsorted
+     * The new list then replaces the one of S, whose express lanes and filter are kept
+     * On a format error, the failbit of is is set and S is not modified
      */
-    friend Set operator+(Set S1, const Set& S2) {
-        return (S1 += S2);
+    friend std::istream& operator>>(std::istream& is, Set& S) {
+        S.read_from_stream(is);
+        return is;
     }
 
     /*
-     * Overloaded operator*: Set intersection S1*S2
-     * S1*S2 is the Set of elements in both sets S1 and S2
-     * Return a new Set representing the intersection of S1 with S2, S1*S2
+     * Overloaded operators +, *, - and ^ are defined in setexpr.h
+     * They build lazy expressions that are evaluated when converted to a Set
      */
-    friend Set operator*(Set S1, const Set& S2) {
-        return (S1 *= S2);
-    }
+};
 
-    /*
-     * Overloaded operator-: Set difference S1-S2
-     * S1-S2 is the Set of elements in Set S1 that do not belong to Set S2
-     * Return a new Set representing the set difference S1-S2
-     */
-    friend Set operator-(Set S1, const Set& S2) {
-        return (S1 -= S2);
+/*
+ * Sets can be used as keys of unordered containers, hashed in O(1) time
+ */
+template <>
+struct std::hash<Set> {
+    std::size_t operator()(const Set& S) const noexcept {
+        return static_cast<std::size_t>(S.hash());
     }
-};
\ No newline at end of file
+};
+
+#include "setexpr.h"
+#include "setiterator.h"
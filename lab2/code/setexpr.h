@@ -0,0 +1,485 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <utility>
+
+#include "set.h"
+#include "node.h"
+
+/** Lazy Set expressions
+ *
+ * S1 + S2, S1 * S2, S1 - S2 and S1 ^ S2 do not compute a Set right away
+ * Instead, they build an expression tree whose leaves are the operands (Sets or ints)
+ * When the expression is converted to a Set (e.g. S = (S1 + S2) * S3 - S4),
+ * all operand lists are walked simultaneously in a single merge pass
+ * and each Node of the result is created exactly once
+ *
+ * Every expression can create a cursor, i.e. an object that visits
+ * the values of the expression in increasing order:
+ *   done()  -- true, if there are no more values
+ *   value() -- current value (only if !done())
+ *   next()  -- move to the next value
+ *
+ * Note: an expression stores references to the lvalue Sets it was built from
+ * Thus, it should not outlive these Sets
+ */
+namespace set_expr {
+
+/* ************************ *
+ * Leaves of an expression   *
+ * ************************ */
+
+/*
+ * Cursor over the nodes of a Set
+ */
+class SetCursor {
+public:
+    explicit SetCursor(const Set& S) : ptr{S.head->next}, end{S.tail} {
+    }
+
+    bool done() const {
+        return ptr == end;
+    }
+
+    int value() const {
+        return ptr->value;
+    }
+
+    void next() {
+        ptr = ptr->next;
+    }
+
+private:
+    const Set::Node* ptr;  // current node
+    const Set::Node* end;  // dummy tail node of the Set
+};
+
+/*
+ * Cursor over a singleton {val}, used for the mixed-mode expressions, e.g. S - 4
+ * No Set (nor Node) is created for val
+ */
+class ValueCursor {
+public:
+    explicit ValueCursor(int v) : val{v} {
+    }
+
+    bool done() const {
+        return end;
+    }
+
+    int value() const {
+        return val;
+    }
+
+    void next() {
+        end = true;
+    }
+
+private:
+    int val;
+    bool end{false};
+};
+
+/*
+ * Leaf referring to an lvalue Set
+ */
+class SetRef {
+public:
+    explicit SetRef(const Set& S) : set{&S} {
+    }
+
+    SetCursor cursor() const {
+        return SetCursor{*set};
+    }
+
+private:
+    const Set* set;
+};
+
+/*
+ * Leaf owning a temporary Set, e.g. Set{V} + S
+ */
+class SetValue {
+public:
+    explicit SetValue(Set&& S) : set{std::move(S)} {
+    }
+
+    SetCursor cursor() const {
+        return SetCursor{set};
+    }
+
+private:
+    Set set;
+};
+
+/*
+ * Leaf storing an int
+ */
+class IntValue {
+public:
+    explicit IntValue(int v) : val{v} {
+    }
+
+    ValueCursor cursor() const {
+        return ValueCursor{val};
+    }
+
+private:
+    int val;
+};
+
+/* ****************************************************** *
+ * Operator cursors: merge the cursors of two operands     *
+ * Invariant: cur is the current value, if end == false    *
+ * ****************************************************** */
+
+/*
+ * Union: values in A or in B
+ */
+template <typename A, typename B>
+class UnionCursor {
+public:
+    UnionCursor(A a, B b) : lhs{std::move(a)}, rhs{std::move(b)} {
+        settle();
+    }
+
+    bool done() const {
+        return end;
+    }
+
+    int value() const {
+        return cur;
+    }
+
+    void next() {
+        if (!lhs.done() && lhs.value() == cur) lhs.next();
+        if (!rhs.done() && rhs.value() == cur) rhs.next();
+        settle();
+    }
+
+private:
+    void settle() {
+        end = lhs.done() && rhs.done();
+        if (end) return;
+
+        if (lhs.done())
+            cur = rhs.value();
+        else if (rhs.done())
+            cur = lhs.value();
+        else
+            cur = std::min(lhs.value(), rhs.value());
+    }
+
+    A lhs;
+    B rhs;
+    int cur{0};
+    bool end{false};
+};
+
+/*
+ * Intersection: values in both A and B
+ */
+template <typename A, typename B>
+class IntersectionCursor {
+public:
+    IntersectionCursor(A a, B b) : lhs{std::move(a)}, rhs{std::move(b)} {
+        settle();
+    }
+
+    bool done() const {
+        return end;
+    }
+
+    int value() const {
+        return cur;
+    }
+
+    void next() {
+        lhs.next();
+        rhs.next();
+        settle();
+    }
+
+private:
+    void settle() {
+        while (!lhs.done() && !rhs.done()) {
+            if (lhs.value() < rhs.value()) {
+                lhs.next();
+            } else if (rhs.value() < lhs.value()) {
+                rhs.next();
+            } else {
+                cur = lhs.value();
+                return;
+            }
+        }
+        end = true;
+    }
+
+    A lhs;
+    B rhs;
+    int cur{0};
+    bool end{false};
+};
+
+/*
+ * Difference: values in A that are not in B
+ */
+template <typename A, typename B>
+class DifferenceCursor {
+public:
+    DifferenceCursor(A a, B b) : lhs{std::move(a)}, rhs{std::move(b)} {
+        settle();
+    }
+
+    bool done() const {
+        return end;
+    }
+
+    int value() const {
+        return cur;
+    }
+
+    void next() {
+        lhs.next();
+        settle();
+    }
+
+private:
+    void settle() {
+        while (!lhs.done()) {
+            int val = lhs.value();
+            while (!rhs.done() && rhs.value() < val) {
+                rhs.next();
+            }
+            if (rhs.done() || rhs.value() != val) {
+                cur = val;
+                return;
+            }
+            lhs.next();
+            rhs.next();
+        }
+        end = true;
+    }
+
+    A lhs;
+    B rhs;
+    int cur{0};
+    bool end{false};
+};
+
+/*
+ * Symmetric difference: values that are in exactly one of A and B
+ */
+template <typename A, typename B>
+class SymmetricDifferenceCursor {
+public:
+    SymmetricDifferenceCursor(A a, B b) : lhs{std::move(a)}, rhs{std::move(b)} {
+        settle();
+    }
+
+    bool done() const {
+        return end;
+    }
+
+    int value() const {
+        return cur;
+    }
+
+    void next() {
+        // settle() guarantees that lhs and rhs are not positioned at the same value
+        if (!lhs.done() && lhs.value() == cur)
+            lhs.next();
+        else
+            rhs.next();
+        settle();
+    }
+
+private:
+    void settle() {
+        while (!lhs.done() && !rhs.done() && lhs.value() == rhs.value()) {
+            lhs.next();
+            rhs.next();
+        }
+
+        end = lhs.done() && rhs.done();
+        if (end) return;
+
+        if (lhs.done())
+            cur = rhs.value();
+        else if (rhs.done())
+            cur = lhs.value();
+        else
+            cur = std::min(lhs.value(), rhs.value());
+    }
+
+    A lhs;
+    B rhs;
+    int cur{0};
+    bool end{false};
+};
+
+/* ******************** *
+ * Expression node       *
+ * ******************** */
+
+template <template <typename, typename> class OpCursor, typename L, typename R>
+class Expr {
+public:
+    Expr(L l, R r) : lhs{std::move(l)}, rhs{std::move(r)} {
+    }
+
+    auto cursor() const {
+        using LC = decltype(lhs.cursor());
+        using RC = decltype(rhs.cursor());
+        return OpCursor<LC, RC>{lhs.cursor(), rhs.cursor()};
+    }
+
+    /*
+     * Count the values of the expression in one merge, without building a Set
+     * e.g. ((S1 + S2) * S3).cardinality()
+     */
+    size_t cardinality() const {
+        size_t n = 0;
+        for (auto c = cursor(); !c.done(); c.next()) {
+            ++n;
+        }
+        return n;
+    }
+
+    /*
+     * Test whether the expression has no values, stopping at the first value found
+     */
+    bool is_empty() const {
+        return cursor().done();
+    }
+
+private:
+    L lhs;
+    R rhs;
+};
+
+/* ****************************************** *
+ * Wrap an operand into an expression leaf     *
+ * ****************************************** */
+
+template <typename T>
+concept SetOperand = std::same_as<std::remove_cvref_t<T>, Set>;
+
+template <typename T>
+concept IntOperand = std::same_as<std::remove_cvref_t<T>, int>;
+
+template <typename T>
+concept Operand = Expression<T> || SetOperand<T> || IntOperand<T>;
+
+// At least one of the operands must be a Set or an expression, i.e. 3 + 4 is not affected
+template <typename L, typename R>
+concept Operands = Operand<L> && Operand<R> && !(IntOperand<L> && IntOperand<R>);
+
+template <Expression E>
+std::remove_cvref_t<E> leaf(E&& expr) {
+    return std::forward<E>(expr);
+}
+
+inline SetRef leaf(const Set& S) {
+    return SetRef{S};
+}
+
+inline SetValue leaf(Set&& S) {
+    return SetValue{std::move(S)};
+}
+
+inline IntValue leaf(int val) {
+    return IntValue{val};
+}
+
+template <typename T>
+using leaf_t = decltype(leaf(std::declval<T>()));
+
+template <template <typename, typename> class OpCursor, typename L, typename R>
+auto make_expr(L&& lhs, R&& rhs) {
+    return Expr<OpCursor, leaf_t<L>, leaf_t<R>>{leaf(std::forward<L>(lhs)),
+                                                leaf(std::forward<R>(rhs))};
+}
+
+}  // namespace set_expr
+
+/* ******************************************************* *
+ * Evaluation of an expression: Set conversion constructor  *
+ * ******************************************************* */
+
+template <set_expr::Expression E>
+Set::Set(const E& expr) : Set{} {  // create an empty list
+    Node* last = head;
+    for (auto c = expr.cursor(); !c.done(); c.next()) {
+        insert_node(last, c.value());
+        last = last->next;
+    }
+}
+
+/* ***************************************************** *
+ * Overloaded operators: build lazy Set expressions       *
+ * Mixed-mode arithmetic with ints is supported, e.g. 4-S *
+ * ***************************************************** */
+
+/*
+ * Overloaded operator+: Set union S1+S2
+ * S1+S2 is the Set of elements in Set S1 or in Set S2 (without repeated elements)
+ */
+template <typename L, typename R>
+    requires set_expr::Operands<L, R>
+auto operator+(L&& S1, R&& S2) {
+    return set_expr::make_expr<set_expr::UnionCursor>(std::forward<L>(S1), std::forward<R>(S2));
+}
+
+/*
+ * Overloaded operator*: Set intersection S1*S2
+ * S1*S2 is the Set of elements in both sets S1 and S2
+ */
+template <typename L, typename R>
+    requires set_expr::Operands<L, R>
+auto operator*(L&& S1, R&& S2) {
+    return set_expr::make_expr<set_expr::IntersectionCursor>(std::forward<L>(S1),
+                                                             std::forward<R>(S2));
+}
+
+/*
+ * Overloaded operator-: Set difference S1-S2
+ * S1-S2 is the Set of elements in Set S1 that do not belong to Set S2
+ */
+template <typename L, typename R>
+    requires set_expr::Operands<L, R>
+auto operator-(L&& S1, R&& S2) {
+    return set_expr::make_expr<set_expr::DifferenceCursor>(std::forward<L>(S1),
+                                                           std::forward<R>(S2));
+}
+
+/*
+ * Overloaded operator^: Set symmetric difference S1^S2
+ * S1^S2 is the Set of elements that belong to exactly one of the sets S1 and S2
+ */
+template <typename L, typename R>
+    requires set_expr::Operands<L, R>
+auto operator^(L&& S1, R&& S2) {
+    return set_expr::make_expr<set_expr::SymmetricDifferenceCursor>(std::forward<L>(S1),
+                                                                    std::forward<R>(S2));
+}
+
+/*
+ * Overloaded operator<< for expressions
+ * Values are written in the same format as for a Set, without creating a Set
+ */
+template <set_expr::Expression E>
+std::ostream& operator<<(std::ostream& os, const E& expr) {
+    auto c = expr.cursor();
+    if (c.done()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (; !c.done(); c.next()) {
+            os << c.value() << " ";
+        }
+        os << "}";
+    }
+    return os;
+}
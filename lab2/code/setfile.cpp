@@ -0,0 +1,326 @@
+#include "setfile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SETFILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*****************************************************
+ * Encoding helpers                                   *
+ ******************************************************/
+
+namespace {
+
+constexpr char magic[8] = {'L', 'A', 'B', '2', 'S', 'E', 'T', '1'};
+constexpr std::size_t header_size = 24;  // magic, number of values, number of blocks
+constexpr std::size_t entry_size = 16;   // first value, number of values, offset
+
+void put_u32(std::vector<unsigned char>& out, std::uint32_t x) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<unsigned char>(x >> (8 * i)));
+    }
+}
+
+void put_u64(std::vector<unsigned char>& out, std::uint64_t x) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<unsigned char>(x >> (8 * i)));
+    }
+}
+
+void put_varint(std::vector<unsigned char>& out, std::uint32_t x) {
+    while (x >= 0x80) {
+        out.push_back(static_cast<unsigned char>(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(x));
+}
+
+std::uint32_t get_u32(const unsigned char* p) {
+    std::uint32_t x = 0;
+    for (int i = 3; i >= 0; --i) {
+        x = (x << 8) | p[i];
+    }
+    return x;
+}
+
+std::uint64_t get_u64(const unsigned char* p) {
+    std::uint64_t x = 0;
+    for (int i = 7; i >= 0; --i) {
+        x = (x << 8) | p[i];
+    }
+    return x;
+}
+
+}  // namespace
+
+/*****************************************************
+ * Writing and reading Set files                      *
+ ******************************************************/
+
+/*
+ * Write the values of Set S to a binary file
+ * The block index and the data are encoded in memory, then written at once
+ */
+bool write_binary(const Set& S, const std::filesystem::path& file) {
+    const std::size_t n_blocks = (S.cardinality() + setfile::block_size - 1) / setfile::block_size;
+    std::vector<unsigned char> index;
+    std::vector<unsigned char> data;
+    index.reserve(header_size + n_blocks * entry_size);
+    data.reserve(S.cardinality() + S.cardinality() / 4);
+
+    index.insert(index.end(), std::begin(magic), std::end(magic));
+    put_u64(index, S.cardinality());
+    put_u64(index, n_blocks);
+
+    std::size_t i = 0;
+    std::uint32_t prev = 0;
+    for (int val : S) {
+        const std::uint32_t x = static_cast<std::uint32_t>(val);
+        if (i % setfile::block_size == 0) {
+            put_u32(index, x);
+            put_u32(index, static_cast<std::uint32_t>(std::min(setfile::block_size, S.cardinality() - i)));
+            put_u64(index, data.size());
+        } else {
+            put_varint(data, x - prev);  // modulo 2^32: the difference of two ints in increasing order
+        }
+        prev = x;
+        ++i;
+    }
+
+    std::ofstream os(file, std::ios::binary);
+    os.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+    os.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(os);
+}
+
+/*
+ * Read a Set from a binary file written by write_binary
+ * Return an empty Set, if the file cannot be read or is not a valid Set file
+ */
+Set read_binary(const std::filesystem::path& file) {
+    const MappedSet M{file};
+    return M.is_open() ? M.to_set() : Set{};
+}
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * Map file, a binary Set file written by write_binary
+ * is_open() is false, if the file cannot be read or is not a valid Set file
+ */
+MappedSet::MappedSet(const std::filesystem::path& file) {
+#ifdef SETFILE_MMAP
+    const int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            const std::size_t size = static_cast<std::size_t>(st.st_size);
+            void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                mapping = p;
+                bytes = static_cast<const unsigned char*>(p);
+                n_bytes = size;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    if (!bytes) {
+        std::ifstream is(file, std::ios::binary);
+        buffer.assign(std::istreambuf_iterator<char>{is}, std::istreambuf_iterator<char>{});
+        if (!buffer.empty()) {
+            bytes = buffer.data();
+            n_bytes = buffer.size();
+        }
+    }
+
+    if (bytes && n_bytes >= header_size) {
+        n_values = static_cast<std::size_t>(get_u64(bytes + 8));
+        n_blocks = static_cast<std::size_t>(get_u64(bytes + 16));
+    }
+    if (!validate()) {
+        close();
+    }
+}
+
+/*
+ * Destructor: unmap the file
+ */
+MappedSet::~MappedSet() {
+    close();
+}
+
+/*
+ * Test whether val belongs to the Set stored in the file
+ * Binary search of the last block whose first value is not larger than val, then decode that block
+ */
+bool MappedSet::is_member(int val) const {
+    std::size_t lo = 0;
+    std::size_t hi = n_blocks;  // blocks [0, lo) start with a value <= val, blocks [hi, n_blocks) with a larger one
+    while (lo < hi) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (block_first(mid) <= val) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0)
+        return false;
+
+    bool found = false;
+    for_each_in_block(lo - 1, [&](int v) {
+        if (v < val)
+            return true;
+        found = (v == val);
+        return false;
+    });
+    return found;
+}
+
+/*
+ * Decode all values into a sorted vector
+ * Return an empty vector, if a block is corrupt or the values do not increase from one block to the next
+ */
+std::vector<int> MappedSet::to_vector() const {
+    std::vector<int> list_of_values;
+    list_of_values.reserve(n_values);
+    for (std::size_t b = 0; b < n_blocks; ++b) {
+        const bool ok = for_each_in_block(b, [&](int v) {
+            if (!list_of_values.empty() && v <= list_of_values.back())
+                return false;
+            list_of_values.push_back(v);
+            return true;
+        });
+        if (!ok)
+            return {};
+    }
+    return list_of_values;
+}
+
+/*
+ * Decode all values into a Set, appending each value in O(1) time
+ * Return an empty Set, if a block is corrupt or the values do not increase from one block to the next
+ */
+Set MappedSet::to_set() const {
+    Set S;
+    for (std::size_t b = 0; b < n_blocks; ++b) {
+        const bool ok = for_each_in_block(b, [&](int v) {
+            if (!S.is_empty() && v <= *std::prev(S.end()))
+                return false;
+            S.insert(S.end(), v);
+            return true;
+        });
+        if (!ok)
+            return Set{};
+    }
+    return S;
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Check the header, the block index (increasing first values) and the offsets of the blocks
+ * The varints are checked while decoding
+ */
+bool MappedSet::validate() const {
+    if (!bytes || n_bytes < header_size || std::memcmp(bytes, magic, sizeof(magic)) != 0)
+        return false;
+    if (n_blocks > (n_bytes - header_size) / entry_size)
+        return false;
+    if (n_blocks != (n_values + setfile::block_size - 1) / setfile::block_size)
+        return false;
+
+    const std::size_t data_size = n_bytes - header_size - n_blocks * entry_size;
+    const unsigned char* index = bytes + header_size;
+    std::uint64_t prev_offset = 0;
+    for (std::size_t b = 0; b < n_blocks; ++b) {
+        const std::uint64_t offset = get_u64(index + b * entry_size + 8);
+        const std::size_t expected = (b + 1 < n_blocks) ? setfile::block_size : n_values - b * setfile::block_size;
+        if (offset < prev_offset || offset > data_size || block_count(b) != expected)
+            return false;
+        if (b > 0 && block_first(b) <= block_first(b - 1))
+            return false;
+        prev_offset = offset;
+    }
+    return true;
+}
+
+/*
+ * First value of block b
+ */
+int MappedSet::block_first(std::size_t b) const {
+    return static_cast<int>(get_u32(bytes + header_size + b * entry_size));
+}
+
+/*
+ * Number of values of block b
+ */
+std::size_t MappedSet::block_count(std::size_t b) const {
+    return get_u32(bytes + header_size + b * entry_size + 4);
+}
+
+/*
+ * Call f for each value of block b, in increasing order
+ * Stop, and return false, as soon as f returns false (or the block is corrupt)
+ */
+template <typename F>
+bool MappedSet::for_each_in_block(std::size_t b, F&& f) const {
+    const unsigned char* index = bytes + header_size;
+    const unsigned char* data = index + n_blocks * entry_size;
+    const unsigned char* p = data + get_u64(index + b * entry_size + 8);
+    const unsigned char* end = (b + 1 < n_blocks) ? data + get_u64(index + (b + 1) * entry_size + 8)
+                                                  : bytes + n_bytes;
+
+    std::uint32_t x = static_cast<std::uint32_t>(block_first(b));
+    if (!f(static_cast<int>(x)))
+        return false;
+
+    for (std::size_t i = 1, n = block_count(b); i < n; ++i) {
+        std::uint32_t delta = 0;
+        for (int shift = 0;; shift += 7) {
+            if (p == end || shift > 28)
+                return false;  // corrupt block
+            const unsigned char byte = *p++;
+            delta |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                break;
+        }
+        if (delta == 0 || static_cast<std::int64_t>(static_cast<int>(x)) + delta > std::numeric_limits<int>::max())
+            return false;  // values not increasing, or past the largest int
+        x += delta;
+        if (!f(static_cast<int>(x)))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Unmap or release the file
+ */
+void MappedSet::close() {
+#ifdef SETFILE_MMAP
+    if (mapping) {
+        ::munmap(mapping, n_bytes);
+    }
+#endif
+    mapping = nullptr;
+    buffer.clear();
+    bytes = nullptr;
+    n_bytes = 0;
+    n_values = 0;
+    n_blocks = 0;
+}
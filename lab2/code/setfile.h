@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "set.h"
+
+/*
+ * Binary files of Sets
+ *
+ * The values are split into blocks of block_size consecutive values
+ * A block stores the differences between consecutive values (all positive) as varints:
+ * 7 bits per byte, the high bit telling whether more bytes follow, i.e. dense Sets take about 1 byte per value
+ * The first value and the position of each block are kept in a block index, after the header
+ *
+ * Layout, all integers little-endian:
+ *   header       magic "LAB2SET1", uint64 number of values, uint64 number of blocks
+ *   block index  per block: int32 first value, uint32 number of values, uint64 offset of its deltas in the data
+ *   data         per block: varint deltas of the values after the first one
+ */
+namespace setfile {
+inline constexpr std::size_t block_size = 128;
+}
+
+/*
+ * Write the values of Set S to a binary file
+ * Return false, if the file cannot be written
+ */
+bool write_binary(const Set& S, const std::filesystem::path& file);
+
+/*
+ * Read a Set from a binary file written by write_binary
+ * Return an empty Set, if the file cannot be read or is not a valid Set file
+ */
+Set read_binary(const std::filesystem::path& file);
+
+/** Class to query a binary Set file without loading it
+ *
+ * The file is memory-mapped (read into memory, on systems without mmap)
+ * is_member finds the block of a value by binary search in the block index,
+ * then decodes only that block, i.e. O(log(n / block_size) + block_size) time
+ */
+class MappedSet {
+public:
+    /*
+     * Map file, a binary Set file written by write_binary
+     * is_open() is false, if the file cannot be read or is not a valid Set file
+     */
+    explicit MappedSet(const std::filesystem::path& file);
+
+    MappedSet(const MappedSet&) = delete;
+    MappedSet& operator=(const MappedSet&) = delete;
+
+    /*
+     * Destructor: unmap the file
+     */
+    ~MappedSet();
+
+    bool is_open() const {
+        return (bytes != nullptr);
+    }
+
+    /*
+     * Test whether val belongs to the Set stored in the file
+     */
+    bool is_member(int val) const;
+
+    bool is_empty() const {
+        return (n_values == 0);
+    }
+
+    size_t cardinality() const {
+        return n_values;
+    }
+
+    /*
+     * Decode all values: return a sorted vector, or a Set
+     */
+    std::vector<int> to_vector() const;
+    Set to_set() const;
+
+private:
+    const unsigned char* bytes{nullptr};  // contents of the file
+    std::size_t n_bytes{0};
+    void* mapping{nullptr};               // address returned by mmap, if the file is mapped
+    std::vector<unsigned char> buffer;    // contents of the file, if it is not mapped
+
+    std::size_t n_values{0};
+    std::size_t n_blocks{0};
+
+    /*
+     * Check the header, the block index (increasing first values) and the offsets of the blocks
+     */
+    bool validate() const;
+
+    /*
+     * First value and number of values of block b
+     */
+    int block_first(std::size_t b) const;
+    std::size_t block_count(std::size_t b) const;
+
+    /*
+     * Call f for each value of block b, in increasing order
+     * Stop, and return false, as soon as f returns false
+     */
+    template <typename F>
+    bool for_each_in_block(std::size_t b, F&& f) const;
+
+    /*
+     * Unmap or release the file
+     */
+    void close();
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** Class Set::Filter
+ *
+ * Optional blocked Bloom filter on the values of a Set, to answer most negative lookups without walking the list
+ * The filter is an array of 512-bit blocks (one cache line each)
+ * A value sets k bits in a single block, chosen by its hash: a lookup reads one cache line
+ * With bits_per_value bits per value, about 1% of the lookups of absent values are false positives
+ *
+ * Inserted values are added to the filter as they come
+ * Removed values cannot be taken out of a Bloom filter: their bits stay set, which only adds false positives
+ * The filter is invalidated when it is full or too many values were removed since it was built,
+ * and invalid filters are rebuilt, in linear time, by the next lookup
+ */
+class Set::Filter {
+public:
+    static constexpr std::size_t bits_per_value = 12;
+    static constexpr int k = 4;  // bits set per value
+
+    /*
+     * Rebuild the filter from the n values of the list delimited by the dummy nodes head and tail
+     */
+    void build(Node* head, Node* tail, std::size_t n) {
+        std::size_t n_blocks = 1;
+        while (n_blocks * 512 < n * bits_per_value) {
+            n_blocks *= 2;
+        }
+        blocks.assign(n_blocks, Block{});
+        mask = n_blocks - 1;
+        capacity = n_blocks * 512 / bits_per_value;
+
+        for (Node* p = head->next; p != tail; p = p->next) {
+            add(p->value);
+        }
+        added = n;
+        removed = 0;
+        valid = true;
+    }
+
+    /*
+     * Test whether val may belong to the Set: false means that it certainly does not
+     */
+    bool may_contain(int val) const {
+        const std::uint64_t h = Set::value_hash(val);
+        const Block& block = blocks[(h >> 36) & mask];
+        for (int i = 0; i < k; ++i) {
+            const unsigned bit = (h >> (9 * i)) & 511;
+            if (!(block.words[bit / 64] & (std::uint64_t{1} << (bit % 64))))
+                return false;
+        }
+        return true;
+    }
+
+    /*
+     * A Node storing val was inserted in the list
+     * The filter is invalidated, instead, when it holds capacity values
+     */
+    void node_inserted(int val) {
+        if (!valid) return;
+        if (++added > capacity) {
+            valid = false;
+            return;
+        }
+        add(val);
+    }
+
+    /*
+     * A Node was removed from the list
+     * The filter is invalidated when a quarter of its values were removed: it would return too many false positives
+     */
+    void node_removed() {
+        if (valid && ++removed * 4 > added) {
+            valid = false;
+        }
+    }
+
+    /*
+     * Mark the filter as invalid, e.g. before removing many Nodes
+     */
+    void invalidate() {
+        valid = false;
+    }
+
+    bool is_valid() const {
+        return valid;
+    }
+
+private:
+    struct alignas(64) Block {
+        std::uint64_t words[8]{};
+    };
+
+    std::vector<Block> blocks;  // a power of two number of blocks
+    std::size_t mask{0};        // blocks.size() - 1
+    std::size_t capacity{0};    // number of values the filter is sized for
+    std::size_t added{0};       // number of values added since the filter was built, including the initial ones
+    std::size_t removed{0};     // number of Nodes removed since then
+    bool valid{false};
+
+    void add(int val) {
+        const std::uint64_t h = Set::value_hash(val);
+        Block& block = blocks[(h >> 36) & mask];
+        for (int i = 0; i < k; ++i) {
+            const unsigned bit = (h >> (9 * i)) & 511;
+            block.words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+};
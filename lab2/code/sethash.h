@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sethash {
+
+/*
+ * Bijective mix of the 32 bits of val into 64 bits: the finalizer of splitmix64
+ * Distinct values get distinct hashes, and close values unrelated ones
+ */
+inline std::uint64_t mix(int val) {
+    std::uint64_t z = static_cast<std::uint32_t>(val) + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+}  // namespace sethash
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/** Class Set::Index
+ *
+ * Optional skip-list "express lanes" on top of the sorted doubly linked list of a Set
+ * Lane 0 refers to every fanout-th Node of the list, lane 1 to every fanout-th entry of lane 0, etc.
+ * The top lane has at most fanout entries
+ * Each entry stores a copy of the Node value, so that searching the lanes does not touch the Nodes
+ *
+ * A seek descends from the top lane to lane 0 (at most fanout entries are inspected per lane)
+ * and then walks the list from the Node found in lane 0, i.e. O(log n) plus the length of that walk
+ *
+ * The lanes never own Nodes and do not change Node::count_nodes
+ * Nodes appended after the last Node extend the lanes, as a rebuild would, in O(1) amortized time
+ * Other inserted Nodes are reached by the final walk in the list: when a seek walks more than max_gap Nodes,
+ * the entries of that gap of lane 0 are added and the upper lanes rebuilt, in O(n / fanout) time
+ * The lanes are also rebuilt once as many Nodes were inserted in the middle of the list as it had when they were built
+ * When a Node referred by the lanes is removed, the entry is moved to the previous Node, if possible
+ * Invalid lanes are rebuilt, in linear time, by the next seek
+ */
+class Set::Index {
+public:
+    static constexpr std::size_t fanout = 4;
+    static constexpr std::size_t max_gap = 4 * fanout;  // longest walk from lane 0 before its gap is split
+
+    struct Entry {
+        int value;   // copy of node->value
+        Node* node;  // Node of the list
+    };
+
+    /*
+     * Rebuild all lanes from the list delimited by the dummy nodes head and tail
+     */
+    void build(Node* head, Node* tail) {
+        lanes.clear();
+        lanes.emplace_back();
+
+        std::size_t pos = 0;
+        for (Node* p = head->next; p != tail; p = p->next) {
+            if (++pos % fanout == 0) {
+                lanes[0].push_back(Entry{p->value, p});
+            }
+        }
+        build_upper_lanes();
+
+        indexed = pos;
+        inserted = 0;
+        tail_run = pos % fanout;
+        valid = true;
+    }
+
+    /*
+     * Return the last Node referred by lane 0 with a value smaller than val,
+     * or head if there is no such Node
+     * The lower bound of val is found by walking the list forward from the returned Node
+     */
+    Node* predecessor(Node* head, int val) const {
+        std::size_t i = 0;  // first entry to inspect in the current lane
+        std::size_t found = 0;  // 1 + position of the last entry with a value smaller than val, 0 if none
+
+        for (std::size_t k = lanes.size(); k-- > 0;) {
+            const std::vector<Entry>& lane = lanes[k];
+            const std::size_t stop = (k + 1 == lanes.size()) ? lane.size() : std::min(lane.size(), i + fanout);
+
+            found = i;
+            while (found < stop && lane[found].value < val) {
+                ++found;
+            }
+            // Entry found-1 of this lane is entry found*fanout-1 of the lane below
+            i = (found == 0) ? 0 : found * fanout - 1;
+        }
+
+        return (found == 0) ? head : lanes[0][found - 1].node;
+    }
+
+    /*
+     * Node p was inserted in the list
+     * A Node appended after the last Node is added to the lanes every fanout Nodes, as by build
+     * Otherwise, the lanes are rebuilt when the number of Nodes inserted in the middle of the list has doubled
+     */
+    void node_inserted(Node* p, Node* tail) {
+        if (!valid) return;
+
+        if (p->next == tail) {
+            if (++tail_run == fanout) {
+                append_entry(Entry{p->value, p});
+                tail_run = 0;
+            }
+        } else if (++inserted > indexed) {
+            valid = false;
+        }
+    }
+
+    /*
+     * A seek walked more than max_gap Nodes from Node from, found in lane 0 (or the head)
+     * Add an entry every fanout Nodes of the gap between from and the next Node of lane 0, and rebuild the upper lanes
+     */
+    void split_gap(Node* from, Node* head, Node* tail) {
+        std::vector<Entry>& lane0 = lanes[0];
+        const std::size_t i = (from == head) ? 0 : static_cast<std::size_t>(
+            std::partition_point(lane0.begin(), lane0.end(), [v = from->value](const Entry& e) { return e.value <= v; }) -
+            lane0.begin());
+        Node* end = (i < lane0.size()) ? lane0[i].node : tail;
+
+        std::vector<Entry> added;
+        std::size_t pos = 0;
+        for (Node* p = from->next; p != end; p = p->next) {
+            if (++pos % fanout == 0) {
+                added.push_back(Entry{p->value, p});
+            }
+        }
+        if (end == tail) {
+            tail_run = pos % fanout;
+        }
+
+        lane0.insert(lane0.begin() + static_cast<std::ptrdiff_t>(i), added.begin(), added.end());
+        build_upper_lanes();
+    }
+
+    /*
+     * Node p is about to be removed from the list
+     * If a lane refers to p, the entry is moved to p's predecessor
+     * The lanes are invalidated, if that is not possible (p->prev is the head or already in lane 0)
+     */
+    void node_removed(Node* p, Node* head) {
+        if (!valid) return;
+
+        std::vector<Entry>& lane0 = lanes[0];
+        if (tail_run > 0 && (lane0.empty() || lane0.back().value < p->value)) {
+            --tail_run;  // p is after the last Node of lane 0
+        }
+        auto it = std::partition_point(lane0.begin(), lane0.end(),
+                                       [v = p->value](const Entry& e) { return e.value < v; });
+        if (it == lane0.end() || it->node != p) return;  // no lane refers to p
+
+        std::size_t i = static_cast<std::size_t>(it - lane0.begin());
+        Node* q = p->prev;
+        if (q == head || (i > 0 && lane0[i - 1].node == q)) {
+            valid = false;
+            return;
+        }
+
+        const Entry e{q->value, q};
+        lane0[i] = e;
+        // Entry i of lane k-1 is entry (i+1)/fanout-1 of lane k, if (i+1) is a multiple of fanout
+        for (std::size_t k = 1; k < lanes.size() && (i + 1) % fanout == 0; ++k) {
+            i = (i + 1) / fanout - 1;
+            lanes[k][i] = e;
+        }
+    }
+
+    /*
+     * Mark the lanes as invalid, e.g. before removing many Nodes
+     */
+    void invalidate() {
+        valid = false;
+    }
+
+    /*
+     * Galloping (exponential) search in lane 0, for increasing values val
+     * \param finger 1 + position of the last entry known to have a value smaller than val (0 if none)
+     * Return 1 + position of the last entry with a value smaller than val (0 if none), i.e. the new finger
+     * Entries finger, finger+1, finger+3, finger+7, ... are probed, then the last interval is binary searched
+     * Thus, the cost is logarithmic in the distance from the finger
+     */
+    std::size_t gallop(std::size_t finger, int val) const {
+        const std::vector<Entry>& lane0 = lanes[0];
+        const std::size_t n = lane0.size();
+
+        std::size_t lo = finger;  // all entries before lo are smaller than val
+        std::size_t step = 1;
+        while (lo < n && lane0[lo].value < val) {
+            const std::size_t hi = std::min(n, lo + step);
+            if (lane0[hi - 1].value >= val) {
+                break;
+            }
+            lo = hi;
+            step *= 2;
+        }
+
+        const std::size_t hi = std::min(n, lo + step);
+        auto it = std::partition_point(lane0.begin() + lo, lane0.begin() + hi,
+                                       [val](const Entry& e) { return e.value < val; });
+        return static_cast<std::size_t>(it - lane0.begin());
+    }
+
+    /*
+     * Node of lane 0 corresponding to a finger returned by gallop (head, if finger == 0)
+     */
+    Node* node_at(std::size_t finger, Node* head) const {
+        return (finger == 0) ? head : lanes[0][finger - 1].node;
+    }
+
+    bool is_valid() const {
+        return valid;
+    }
+
+private:
+    std::vector<std::vector<Entry>> lanes;  // lanes[0] is the bottom lane
+    std::size_t indexed{0};                 // number of Nodes in the list when the lanes were built
+    std::size_t inserted{0};                // number of Nodes inserted since then, in the middle of the list
+    std::size_t tail_run{0};                // number of Nodes after the last Node of lane 0
+    bool valid{false};
+
+    /*
+     * Rebuild lanes 1, 2, ... from lane 0: every fanout-th entry of a lane goes to the lane above
+     */
+    void build_upper_lanes() {
+        lanes.resize(1);
+        while (lanes.back().size() > fanout) {
+            const std::vector<Entry>& below = lanes.back();
+            std::vector<Entry> lane;
+            lane.reserve(below.size() / fanout);
+            for (std::size_t i = fanout - 1; i < below.size(); i += fanout) {
+                lane.push_back(below[i]);
+            }
+            lanes.push_back(std::move(lane));
+        }
+    }
+
+    /*
+     * Append entry e, of the last Node, to lane 0 and to the upper lanes it belongs to
+     */
+    void append_entry(const Entry& e) {
+        lanes[0].push_back(e);
+        for (std::size_t k = 1; k < lanes.size() && lanes[k - 1].size() % fanout == 0; ++k) {
+            lanes[k].push_back(e);
+        }
+        while (lanes.back().size() > fanout) {  // the top lane is full: add a lane above it
+            const std::vector<Entry>& below = lanes.back();
+            std::vector<Entry> lane;
+            for (std::size_t i = fanout - 1; i < below.size(); i += fanout) {
+                lane.push_back(below[i]);
+            }
+            lanes.push_back(std::move(lane));
+        }
+    }
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+
+#include "set.h"
+#include "node.h"
+
+/** Class Set::const_iterator
+ *
+ * Bidirectional iterator over the values of a Set, in increasing order
+ * It points to a Node of the list: end() points to the dummy tail Node
+ * An iterator stays valid until the Node it points to is removed
+ */
+class Set::const_iterator {
+public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = int;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const int*;
+    using reference = const int&;
+
+    const_iterator() = default;
+
+    reference operator*() const {
+        return ptr->value;
+    }
+
+    pointer operator->() const {
+        return &ptr->value;
+    }
+
+    const_iterator& operator++() {
+        ptr = ptr->next;
+        return *this;
+    }
+
+    const_iterator operator++(int) {
+        const_iterator old{*this};
+        ptr = ptr->next;
+        return old;
+    }
+
+    const_iterator& operator--() {
+        ptr = ptr->prev;
+        return *this;
+    }
+
+    const_iterator operator--(int) {
+        const_iterator old{*this};
+        ptr = ptr->prev;
+        return old;
+    }
+
+    bool operator==(const const_iterator& other) const = default;
+
+private:
+    friend class Set;
+
+    explicit const_iterator(Node* p) : ptr{p} {
+    }
+
+    Node* ptr{nullptr};
+};
+
+inline Set::const_iterator Set::begin() const {
+    return const_iterator{head->next};
+}
+
+inline Set::const_iterator Set::end() const {
+    return const_iterator{tail};
+}
+
+inline auto Set::range(int lo, int hi) const {
+    const auto [first, last] = range_bounds(lo, hi);
+    return std::ranges::subrange<const_iterator>{const_iterator{first}, const_iterator{last}};
+}
@@ -0,0 +1,426 @@
+#include "setkernels.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SETKERNELS_X86 1
+#include <immintrin.h>
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace setkernels {
+
+namespace {
+
+/* ***************** *
+ * Scalar kernels     *
+ * ***************** */
+
+/*
+ * Union of a and b, a value equal to last is not written (if has_last)
+ * Used also for the tails of the vectorized union
+ */
+std::size_t unite_scalar(const int* a, std::size_t na, const int* b, std::size_t nb, int* out,
+                         bool has_last = false, int last = 0) {
+    std::size_t i = 0, j = 0, k = 0;
+
+    auto emit = [&](int val) {
+        if (!has_last || val != last) {
+            out[k++] = val;
+            last = val;
+            has_last = true;
+        }
+    };
+
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            emit(a[i++]);
+        } else if (b[j] < a[i]) {
+            emit(b[j++]);
+        } else {
+            emit(a[i++]);
+            ++j;
+        }
+    }
+    while (i < na) emit(a[i++]);
+    while (j < nb) emit(b[j++]);
+    return k;
+}
+
+std::size_t intersect_scalar(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    std::size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            out[k++] = a[i++];
+            ++j;
+        }
+    }
+    return k;
+}
+
+std::size_t subtract_scalar(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    std::size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            out[k++] = a[i++];
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            ++i;
+            ++j;
+        }
+    }
+    while (i < na) out[k++] = a[i++];
+    return k;
+}
+
+#ifdef SETKERNELS_X86
+
+/* ****************************************************** *
+ * Compress tables: move the selected lanes to the front   *
+ * ****************************************************** */
+
+// pshufb masks for 4 lanes of 32 bits, indexed by a 4-bit lane mask
+const auto compress4 = [] {
+    std::array<std::array<std::uint8_t, 16>, 16> table{};
+    for (int mask = 0; mask < 16; ++mask) {
+        int k = 0;
+        for (int lane = 0; lane < 4; ++lane) {
+            if (mask & (1 << lane)) {
+                for (int byte = 0; byte < 4; ++byte) {
+                    table[mask][4 * k + byte] = static_cast<std::uint8_t>(4 * lane + byte);
+                }
+                ++k;
+            }
+        }
+        for (; k < 4; ++k) {
+            for (int byte = 0; byte < 4; ++byte) {
+                table[mask][4 * k + byte] = 0x80;  // zero
+            }
+        }
+    }
+    return table;
+}();
+
+// vpermd indices for 8 lanes of 32 bits, indexed by an 8-bit lane mask
+const auto compress8 = [] {
+    std::array<std::array<std::uint32_t, 8>, 256> table{};
+    for (int mask = 0; mask < 256; ++mask) {
+        int k = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            if (mask & (1 << lane)) {
+                table[mask][k++] = static_cast<std::uint32_t>(lane);
+            }
+        }
+    }
+    return table;
+}();
+
+/* ***************** *
+ * SSE4.1 kernels     *
+ * ***************** */
+
+// Store the lanes of v selected by mask at out, return the number of stored lanes
+TARGET_SSE41 inline std::size_t store_selected4(int* out, __m128i v, int mask) {
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(compress4[mask].data()));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(v, shuffle));
+    return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(mask)));
+}
+
+// Bit i of the result is set, if lane i of va is equal to some lane of vb
+TARGET_SSE41 inline int match4(__m128i va, __m128i vb) {
+    const __m128i m0 = _mm_cmpeq_epi32(va, vb);
+    const __m128i m1 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+    const __m128i m2 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+    const __m128i m3 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+    const __m128i m = _mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3));
+    return _mm_movemask_ps(_mm_castsi128_ps(m));
+}
+
+TARGET_SSE41 std::size_t intersect_sse41(const int* a, std::size_t na, const int* b, std::size_t nb,
+                                         int* out) {
+    std::size_t i = 0, j = 0, k = 0;
+
+    while (i + 4 <= na && j + 4 <= nb) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        k += store_selected4(out + k, va, match4(va, vb));
+
+        // Advance the block(s) with the smallest last value
+        const int a_max = a[i + 3];
+        const int b_max = b[j + 3];
+        i += (a_max <= b_max) ? 4 : 0;
+        j += (b_max <= a_max) ? 4 : 0;
+    }
+
+    // Values of b before j are smaller than the values of a not yet compared with them
+    return k + intersect_scalar(a + i, na - i, b + j, nb - j, out + k);
+}
+
+TARGET_SSE41 std::size_t subtract_sse41(const int* a, std::size_t na, const int* b, std::size_t nb,
+                                        int* out) {
+    std::size_t i = 0, j = 0, k = 0;
+    int matched = 0;  // lanes of the current block of a found in b, so far
+
+    while (i + 4 <= na && j + 4 <= nb) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        matched |= match4(va, vb);
+
+        const int a_max = a[i + 3];
+        const int b_max = b[j + 3];
+        if (a_max <= b_max) {  // the block of a is done
+            k += store_selected4(out + k, va, ~matched & 0xF);
+            matched = 0;
+            i += 4;
+        }
+        j += (b_max <= a_max) ? 4 : 0;
+    }
+
+    // The current block of a may be partially matched
+    if (i + 4 <= na) {
+        for (std::size_t lane = 0; lane < 4; ++lane, ++i) {
+            if (matched & (1 << lane)) continue;
+            while (j < nb && b[j] < a[i]) ++j;
+            if (j < nb && b[j] == a[i])
+                ++j;
+            else
+                out[k++] = a[i];
+        }
+    }
+    return k + subtract_scalar(a + i, na - i, b + j, nb - j, out + k);
+}
+
+// Sort a bitonic sequence of 4 ints
+TARGET_SSE41 inline __m128i sort_bitonic4(__m128i v) {
+    __m128i s = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    v = _mm_blend_epi16(_mm_min_epi32(v, s), _mm_max_epi32(v, s), 0xF0);  // lanes 2,3 get the max
+    s = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_blend_epi16(_mm_min_epi32(v, s), _mm_max_epi32(v, s), 0xCC);  // lanes 1,3 get the max
+    return v;
+}
+
+// Merge two sorted blocks: lo gets the 4 smallest ints, hi the 4 largest, both sorted
+TARGET_SSE41 inline void bitonic_merge4(__m128i& lo, __m128i& hi) {
+    const __m128i rev = _mm_shuffle_epi32(hi, _MM_SHUFFLE(0, 1, 2, 3));
+    const __m128i l = _mm_min_epi32(lo, rev);
+    const __m128i h = _mm_max_epi32(lo, rev);
+    lo = sort_bitonic4(l);
+    hi = sort_bitonic4(h);
+}
+
+TARGET_SSE41 std::size_t unite_sse41(const int* a, std::size_t na, const int* b, std::size_t nb,
+                                     int* out) {
+    if (na < 4 || nb < 4) {
+        return unite_scalar(a, na, b, nb, out);
+    }
+
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b));
+    std::size_t i = 4, j = 4, k = 0;
+
+    // Lane 3 of last is the last value written, initially a value different from the first one
+    __m128i last = _mm_set1_epi32(~std::min(a[0], b[0]));
+
+    while (true) {
+        bitonic_merge4(lo, hi);
+
+        // Write lo, except the lanes equal to their predecessor in the merged sequence
+        const __m128i prev = _mm_alignr_epi8(lo, last, 12);
+        const int dup = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lo, prev)));
+        k += store_selected4(out + k, lo, ~dup & 0xF);
+        last = lo;
+
+        if (i + 4 > na || j + 4 > nb) break;
+
+        // Next block: from the array with the smallest next value
+        if (a[i] <= b[j]) {
+            lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            i += 4;
+        } else {
+            lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+            j += 4;
+        }
+    }
+
+    // Merge hi with the shortest tail (less than 4 ints), then with the other tail
+    alignas(16) int pending[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(pending), hi);
+    const int last_value = _mm_extract_epi32(last, 3);
+
+    const int* s = a + i;
+    std::size_t ns = na - i;
+    const int* l = b + j;
+    std::size_t nl = nb - j;
+    if (ns > nl) {
+        std::swap(s, l);
+        std::swap(ns, nl);
+    }
+
+    int merged[8];
+    const std::size_t nm = unite_scalar(pending, 4, s, ns, merged);
+    return k + unite_scalar(merged, nm, l, nl, out + k, true, last_value);
+}
+
+/* ***************** *
+ * AVX2 kernels       *
+ * ***************** */
+
+TARGET_AVX2 inline std::size_t store_selected8(int* out, __m256i v, int mask) {
+    const __m256i perm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(compress8[mask].data()));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(v, perm));
+    return static_cast<std::size_t>(std::popcount(static_cast<unsigned>(mask)));
+}
+
+TARGET_AVX2 inline int match8(__m256i va, __m256i vb) {
+    __m256i m = _mm256_cmpeq_epi32(va, vb);
+    __m256i rot = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i seven = _mm256_set1_epi32(7);
+    for (int r = 1; r < 8; ++r) {
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(vb, rot)));
+        rot = _mm256_and_si256(_mm256_add_epi32(rot, one), seven);
+    }
+    return _mm256_movemask_ps(_mm256_castsi256_ps(m));
+}
+
+TARGET_AVX2 std::size_t intersect_avx2(const int* a, std::size_t na, const int* b, std::size_t nb,
+                                       int* out) {
+    std::size_t i = 0, j = 0, k = 0;
+
+    while (i + 8 <= na && j + 8 <= nb) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        k += store_selected8(out + k, va, match8(va, vb));
+
+        const int a_max = a[i + 7];
+        const int b_max = b[j + 7];
+        i += (a_max <= b_max) ? 8 : 0;
+        j += (b_max <= a_max) ? 8 : 0;
+    }
+    return k + intersect_sse41(a + i, na - i, b + j, nb - j, out + k);
+}
+
+TARGET_AVX2 std::size_t subtract_avx2(const int* a, std::size_t na, const int* b, std::size_t nb,
+                                      int* out) {
+    std::size_t i = 0, j = 0, k = 0;
+    int matched = 0;
+
+    while (i + 8 <= na && j + 8 <= nb) {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        matched |= match8(va, vb);
+
+        const int a_max = a[i + 7];
+        const int b_max = b[j + 7];
+        if (a_max <= b_max) {
+            k += store_selected8(out + k, va, ~matched & 0xFF);
+            matched = 0;
+            i += 8;
+        }
+        j += (b_max <= a_max) ? 8 : 0;
+    }
+
+    if (i + 8 <= na) {
+        for (std::size_t lane = 0; lane < 8; ++lane, ++i) {
+            if (matched & (1 << lane)) continue;
+            while (j < nb && b[j] < a[i]) ++j;
+            if (j < nb && b[j] == a[i])
+                ++j;
+            else
+                out[k++] = a[i];
+        }
+    }
+    return k + subtract_sse41(a + i, na - i, b + j, nb - j, out + k);
+}
+
+#endif  // SETKERNELS_X86
+
+/* ************************* *
+ * Runtime dispatch           *
+ * ************************* */
+
+using Kernel = std::size_t (*)(const int*, std::size_t, const int*, std::size_t, int*);
+
+struct Kernels {
+    Isa isa;
+    Kernel unite;
+    Kernel intersect;
+    Kernel subtract;
+};
+
+std::size_t unite_default(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    return unite_scalar(a, na, b, nb, out);
+}
+
+Kernels kernels_for(Isa isa) {
+    switch (isa) {
+#ifdef SETKERNELS_X86
+        case Isa::avx2:
+            return {isa, unite_sse41, intersect_avx2, subtract_avx2};
+        case Isa::sse41:
+            return {isa, unite_sse41, intersect_sse41, subtract_sse41};
+#endif
+        default:
+            return {Isa::scalar, unite_default, intersect_scalar, subtract_scalar};
+    }
+}
+
+Kernels& active() {
+    static Kernels kernels = kernels_for(best_isa());
+    return kernels;
+}
+
+}  // namespace
+
+Isa best_isa() {
+#ifdef SETKERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Isa::avx2;
+    if (__builtin_cpu_supports("sse4.1")) return Isa::sse41;
+#endif
+    return Isa::scalar;
+}
+
+Isa current_isa() {
+    return active().isa;
+}
+
+bool use_isa(Isa isa) {
+    if (static_cast<int>(isa) > static_cast<int>(best_isa())) return false;
+    active() = kernels_for(isa);
+    return true;
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::avx2:
+            return "avx2";
+        case Isa::sse41:
+            return "sse4.1";
+        default:
+            return "scalar";
+    }
+}
+
+std::size_t unite(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    return active().unite(a, na, b, nb, out);
+}
+
+std::size_t intersect(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    return active().intersect(a, na, b, nb, out);
+}
+
+std::size_t subtract(const int* a, std::size_t na, const int* b, std::size_t nb, int* out) {
+    return active().subtract(a, na, b, nb, out);
+}
+
+}  // namespace setkernels
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+
+/** Merge kernels for sorted arrays of distinct ints
+ *
+ * These functions implement set union, intersection and difference on contiguous storage,
+ * e.g. the sorted vector of a FlatSet
+ * Each kernel has a scalar version and vectorized versions:
+ *   intersection and difference: block-wise all-pairs comparison (4 ints with SSE, 8 ints with AVX2)
+ *   union: bitonic merge network on blocks of 4 ints (SSE4.1) with vectorized removal of duplicates
+ * The best version supported by the CPU is selected at runtime
+ *
+ * The output array must have room for the result plus padding ints,
+ * since the vectorized kernels write whole blocks
+ */
+namespace setkernels {
+
+// Extra room needed at the end of an output array
+constexpr std::size_t padding = 8;
+
+// Instruction sets that the kernels may use
+enum class Isa { scalar, sse41, avx2 };
+
+/*
+ * Return the best instruction set supported by the CPU
+ */
+Isa best_isa();
+
+/*
+ * Return the instruction set used by the kernels (initially, best_isa())
+ */
+Isa current_isa();
+
+/*
+ * Use the given instruction set, e.g. to compare the versions of the kernels
+ * Return false (and do nothing), if the CPU does not support it
+ * This function is not thread-safe: it should not be called while kernels are running
+ */
+bool use_isa(Isa isa);
+
+/*
+ * Name of an instruction set: "scalar", "sse4.1" or "avx2"
+ */
+const char* isa_name(Isa isa);
+
+/*
+ * Write the union of a[0..na) and b[0..nb) to out
+ * out must have room for na + nb + padding ints
+ * Return the number of ints in the union
+ */
+std::size_t unite(const int* a, std::size_t na, const int* b, std::size_t nb, int* out);
+
+/*
+ * Write the intersection of a[0..na) and b[0..nb) to out
+ * out must have room for min(na, nb) + padding ints
+ * Return the number of ints in the intersection
+ */
+std::size_t intersect(const int* a, std::size_t na, const int* b, std::size_t nb, int* out);
+
+/*
+ * Write the difference a[0..na) - b[0..nb) to out
+ * out must have room for na + padding ints
+ * Return the number of ints in the difference
+ */
+std::size_t subtract(const int* a, std::size_t na, const int* b, std::size_t nb, int* out);
+
+}  // namespace setkernels
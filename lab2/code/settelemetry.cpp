@@ -0,0 +1,151 @@
+#include "settelemetry.h"
+
+#include <atomic>
+#include <bit>
+#include <sstream>
+
+/*****************************************************
+ * Counters                                           *
+ ******************************************************/
+
+namespace settelemetry {
+
+namespace {
+
+constexpr std::array<const char*, n_operations> names{"construct", "copy", "is_member", "is_member_batch",
+                                                      "insert",    "erase", "==",        "<=>",
+                                                      "+=",        "*=",    "-=",        "make_empty"};
+
+#ifdef SET_TELEMETRY
+
+std::atomic<std::uint64_t> nodes_allocated{0};
+std::atomic<std::uint64_t> nodes_freed{0};
+std::atomic<std::uint64_t> live_nodes{0};  // not allocated - freed: both loads could see different instants
+std::atomic<std::uint64_t> peak_live_nodes{0};
+std::atomic<std::uint64_t> live_bytes{0};
+std::atomic<std::uint64_t> peak_bytes{0};
+
+struct AtomicStats {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> total_ns{0};
+    std::array<std::atomic<std::uint64_t>, n_buckets> histogram{};
+};
+
+std::array<AtomicStats, n_operations> operation_stats;
+
+/*
+ * Raise peak to value, if value is larger
+ */
+void raise(std::atomic<std::uint64_t>& peak, std::uint64_t value) {
+    std::uint64_t old = peak.load(std::memory_order_relaxed);
+    while (old < value && !peak.compare_exchange_weak(old, value, std::memory_order_relaxed)) {
+    }
+}
+
+#endif
+
+}  // namespace
+
+/*
+ * Name of operation op, as used in the JSON output
+ */
+const char* name(Operation op) {
+    return names[static_cast<std::size_t>(op)];
+}
+
+#ifdef SET_TELEMETRY
+
+void node_allocated(std::size_t bytes) {
+    nodes_allocated.fetch_add(1, std::memory_order_relaxed);
+    raise(peak_live_nodes, live_nodes.fetch_add(1, std::memory_order_relaxed) + 1);
+    raise(peak_bytes, live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void node_freed(std::size_t bytes) {
+    nodes_freed.fetch_add(1, std::memory_order_relaxed);
+    live_nodes.fetch_sub(1, std::memory_order_relaxed);
+    live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void record(Operation op, std::uint64_t ns) {
+    AtomicStats& stats = operation_stats[static_cast<std::size_t>(op)];
+    stats.calls.fetch_add(1, std::memory_order_relaxed);
+    stats.total_ns.fetch_add(ns, std::memory_order_relaxed);
+    const std::size_t bucket = std::min<std::size_t>(std::bit_width(ns), n_buckets - 1);
+    stats.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif
+
+/*
+ * Return the current values of all counters
+ */
+Snapshot snapshot() {
+    Snapshot S;
+#ifdef SET_TELEMETRY
+    S.nodes_allocated = nodes_allocated.load(std::memory_order_relaxed);
+    S.nodes_freed = nodes_freed.load(std::memory_order_relaxed);
+    S.live_nodes = live_nodes.load(std::memory_order_relaxed);
+    S.peak_live_nodes = peak_live_nodes.load(std::memory_order_relaxed);
+    S.live_bytes = live_bytes.load(std::memory_order_relaxed);
+    S.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < n_operations; ++i) {
+        S.operations[i].calls = operation_stats[i].calls.load(std::memory_order_relaxed);
+        S.operations[i].total_ns = operation_stats[i].total_ns.load(std::memory_order_relaxed);
+        for (std::size_t b = 0; b < n_buckets; ++b) {
+            S.operations[i].histogram[b] = operation_stats[i].histogram[b].load(std::memory_order_relaxed);
+        }
+    }
+#endif
+    return S;
+}
+
+/*
+ * Set all counters to 0, except the live nodes and bytes, and set the peaks to the current values
+ * The live nodes are kept by counting them as allocated since the reset
+ */
+void reset() {
+#ifdef SET_TELEMETRY
+    const std::uint64_t live = live_nodes.load();
+    nodes_allocated = live;
+    nodes_freed = 0;
+    peak_live_nodes = live;
+    peak_bytes = live_bytes.load();
+    for (AtomicStats& stats : operation_stats) {
+        stats.calls = 0;
+        stats.total_ns = 0;
+        for (auto& count : stats.histogram) count = 0;
+    }
+#endif
+}
+
+/*
+ * Return the snapshot as a JSON object, with the operations that were called
+ * Trailing empty buckets of the histograms are left out
+ */
+std::string Snapshot::to_json() const {
+    std::ostringstream os;
+    os << "{\"enabled\": " << (enabled ? "true" : "false") << ", \"nodes\": {\"allocated\": " << nodes_allocated
+       << ", \"freed\": " << nodes_freed << ", \"live\": " << live_nodes << ", \"peak_live\": " << peak_live_nodes
+       << "}, \"bytes\": {\"live\": " << live_bytes << ", \"peak\": " << peak_bytes << "}, \"operations\": {";
+
+    const char* separator = "";
+    for (std::size_t i = 0; i < n_operations; ++i) {
+        const OperationStats& stats = operations[i];
+        if (stats.calls == 0)
+            continue;
+        os << separator << "\"" << names[i] << "\": {\"calls\": " << stats.calls << ", \"total_ns\": "
+           << stats.total_ns << ", \"histogram_log2_ns\": [";
+        std::size_t used = n_buckets;
+        while (used > 0 && stats.histogram[used - 1] == 0) --used;
+        for (std::size_t b = 0; b < used; ++b) {
+            os << (b > 0 ? ", " : "") << stats.histogram[b];
+        }
+        os << "]}";
+        separator = ", ";
+    }
+    os << "}}";
+    return os.str();
+}
+
+}  // namespace settelemetry
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+ * Telemetry of class Set: node allocations and calls of the Set operations
+ *
+ * Compiled in only when SET_TELEMETRY is defined (cmake -DSET_TELEMETRY=ON)
+ * Otherwise node_allocated, node_freed and Timer are empty inline functions and classes,
+ * so that the instrumented code is exactly the code without telemetry,
+ * and snapshot() returns a Snapshot with all counters 0
+ *
+ * The counters are atomic, since Set::union_all and Set::intersect_all create nodes in several threads
+ * Calls made by other instrumented operations (e.g. make_empty by the destructor) are counted as well
+ */
+namespace settelemetry {
+
+#ifdef SET_TELEMETRY
+inline constexpr bool enabled = true;
+#else
+inline constexpr bool enabled = false;
+#endif
+
+/*
+ * The instrumented Set operations
+ */
+enum class Operation {
+    construct,  // from a sorted vector
+    copy,
+    is_member,
+    is_member_batch,  // is_member(queries, bitmap)
+    insert,
+    erase,
+    equal,    // ==
+    compare,  // <=>
+    unite,      // +=
+    intersect,  // *=
+    subtract,   // -=
+    make_empty,
+    count  // number of operations
+};
+
+inline constexpr std::size_t n_operations = static_cast<std::size_t>(Operation::count);
+
+/*
+ * Latency histogram buckets: bucket 0 counts calls of 0 ns, bucket b > 0 calls of [2^(b-1), 2^b) ns
+ * and the last bucket all longer calls
+ */
+inline constexpr std::size_t n_buckets = 40;
+
+/*
+ * Name of operation op, as used in the JSON output
+ */
+const char* name(Operation op);
+
+struct OperationStats {
+    std::uint64_t calls{0};
+    std::uint64_t total_ns{0};
+    std::array<std::uint64_t, n_buckets> histogram{};
+};
+
+/*
+ * Copy of the counters at a given time
+ */
+struct Snapshot {
+    std::uint64_t nodes_allocated{0};
+    std::uint64_t nodes_freed{0};
+    std::uint64_t live_nodes{0};
+    std::uint64_t peak_live_nodes{0};  // since the start of the program, or the last reset()
+    std::uint64_t live_bytes{0};
+    std::uint64_t peak_bytes{0};
+    std::array<OperationStats, n_operations> operations{};
+
+    const OperationStats& operator[](Operation op) const {
+        return operations[static_cast<std::size_t>(op)];
+    }
+
+    /*
+     * Return the snapshot as a JSON object, with the operations that were called
+     */
+    std::string to_json() const;
+};
+
+/*
+ * Return the current values of all counters
+ */
+Snapshot snapshot();
+
+/*
+ * Set all counters to 0, except the live nodes and bytes, and set the peaks to the current values
+ */
+void reset();
+
+#ifdef SET_TELEMETRY
+
+void node_allocated(std::size_t bytes);
+void node_freed(std::size_t bytes);
+void record(Operation op, std::uint64_t ns);
+
+/*
+ * Measure the time from its construction to its destruction, as a call of op
+ */
+class Timer {
+public:
+    explicit Timer(Operation op) : op{op}, start{std::chrono::steady_clock::now()} {
+    }
+
+    ~Timer() {
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        record(op, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+
+private:
+    Operation op;
+    std::chrono::steady_clock::time_point start;
+};
+
+#else
+
+inline void node_allocated(std::size_t) {
+}
+
+inline void node_freed(std::size_t) {
+}
+
+class Timer {
+public:
+    explicit constexpr Timer(Operation) {
+    }
+};
+
+#endif
+
+}  // namespace settelemetry
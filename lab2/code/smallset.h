@@ -0,0 +1,380 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "set.h"
+
+/** Class template to represent a Set of ints with inline storage for small sets
+ *
+ * SmallSet<N> stores up to N sorted values in an array inside the SmallSet object,
+ * so that creating, copying and destroying an empty or small set allocates nothing on the heap
+ * When it grows past N values, the values are moved to a Set allocated on the heap (the SmallSet spills),
+ * and all operations are forwarded to that Set
+ * A spilled SmallSet moves its values back inline when they fit in half the array (N / 2),
+ * so that a set oscillating around N values does not spill at every insertion
+ *
+ * It has the same interface as class Set
+ * Operations on two inline SmallSets merge the arrays, and take O(N) time without any heap allocation
+ */
+template <std::size_t N = 16>
+class SmallSet {
+    static_assert(N > 0, "a SmallSet needs room for at least one value");
+
+public:
+    /*
+     *  Default constructor :create an empty SmallSet
+     */
+    SmallSet() = default;
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    SmallSet(int val) : counter{1} {
+        values[0] = val;
+    }
+
+    /*
+     * Constructor to create a SmallSet from a sorted vector of ints
+     */
+    explicit SmallSet(const std::vector<int>& list_of_values) {
+        assign(list_of_values.begin(), list_of_values.end(), list_of_values.size());
+    }
+
+    /*
+     * Constructor to create a SmallSet with the same elements as Set S
+     */
+    explicit SmallSet(const Set& S) {
+        if (S.cardinality() <= N) {
+            assign(S.begin(), S.end(), S.cardinality());
+        } else {
+            spilled = new Set{S};
+        }
+    }
+
+    /*
+     * Copy constructor: create a new SmallSet as a copy of S
+     */
+    SmallSet(const SmallSet& S) : counter{S.counter}, spilled{S.spilled ? new Set{*S.spilled} : nullptr} {
+        std::copy(S.values, S.values + S.counter, values);
+    }
+
+    /*
+     * Move constructor: steal the heap Set of S, if any, S becomes an empty SmallSet
+     */
+    SmallSet(SmallSet&& S) : counter{S.counter}, spilled{S.spilled} {
+        std::copy(S.values, S.values + S.counter, values);
+        S.counter = 0;
+        S.spilled = nullptr;
+    }
+
+    /*
+     * Destructor: deallocate the heap Set, if any
+     */
+    ~SmallSet() {
+        delete spilled;
+    }
+
+    /*
+     * Assignment operator, call by value is used
+     */
+    SmallSet& operator=(SmallSet S) {
+        std::swap(spilled, S.spilled);
+        counter = S.counter;
+        std::copy(S.values, S.values + S.counter, values);
+        return *this;
+    }
+
+    /*
+     * Return a Set with the same elements as the SmallSet
+     */
+    Set to_set() const {
+        if (spilled)
+            return *spilled;
+        Set S;
+        for (std::size_t i = 0; i < counter; ++i) {
+            S.insert(S.end(), values[i]);
+        }
+        return S;
+    }
+
+    /*
+     * Return a sorted vector with all ints in the SmallSet
+     */
+    std::vector<int> to_vector() const {
+        return visit([](auto first, auto last) { return std::vector<int>(first, last); });
+    }
+
+    /*
+     * Transform the SmallSet into an empty set, stored inline
+     */
+    void make_empty() {
+        delete spilled;
+        spilled = nullptr;
+        counter = 0;
+    }
+
+    /*
+     * Test whether val belongs to the SmallSet
+     */
+    bool is_member(int val) const {
+        return spilled ? spilled->is_member(val) : std::binary_search(values, values + counter, val);
+    }
+
+    /*
+     * Add val to the SmallSet, spilling to the heap if the array is full
+     * Return false, if val already belongs to the SmallSet
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val from the SmallSet
+     * Return false, if val does not belong to the SmallSet
+     */
+    bool erase(int val);
+
+    bool is_empty() const {
+        return (cardinality() == 0);
+    }
+
+    size_t cardinality() const {
+        return spilled ? spilled->cardinality() : counter;
+    }
+
+    /*
+     * Test whether the values are stored inline, i.e. the SmallSet uses no heap memory
+     */
+    bool is_inline() const {
+        return (spilled == nullptr);
+    }
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const SmallSet& S) const {
+        if (spilled && S.spilled)
+            return (*spilled == *S.spilled);
+        return visit([&](auto first1, auto last1) {
+            return S.visit([&](auto first2, auto last2) { return std::equal(first1, last1, first2, last2); });
+        });
+    }
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const SmallSet& S) const;
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     */
+    SmallSet& operator+=(const SmallSet& S) {
+        return combine(
+            S, [](auto... ranges) { return std::set_union(ranges...); }, [](Set& S1, const Set& S2) { S1 += S2; });
+    }
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     */
+    SmallSet& operator*=(const SmallSet& S) {
+        return combine(
+            S, [](auto... ranges) { return std::set_intersection(ranges...); },
+            [](Set& S1, const Set& S2) { S1 *= S2; });
+    }
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     */
+    SmallSet& operator-=(const SmallSet& S) {
+        return combine(
+            S, [](auto... ranges) { return std::set_difference(ranges...); },
+            [](Set& S1, const Set& S2) { S1 -= S2; });
+    }
+
+private:
+    std::size_t counter{0};    // number of values stored inline, 0 if spilled
+    Set* spilled{nullptr};     // the values, if there are too many to be stored inline
+    int values[N];             // values[0, counter), sorted
+
+    /*
+     * Store the n sorted values [first, last) inline, or in a heap Set if n > N
+     */
+    template <typename It>
+    void assign(It first, It last, std::size_t n) {
+        if (n <= N) {
+            counter = static_cast<std::size_t>(std::copy(first, last, values) - values);
+        } else {
+            spilled = new Set{std::vector<int>(first, last)};
+            counter = 0;
+        }
+    }
+
+    /*
+     * Move the values to a heap Set
+     */
+    void spill() {
+        if (!spilled) {
+            spilled = new Set{to_set()};
+            counter = 0;
+        }
+    }
+
+    /*
+     * Move the values of the heap Set back inline, if they fit in half the array
+     */
+    void unspill() {
+        if (spilled && spilled->cardinality() <= N / 2) {
+            Set* S = std::exchange(spilled, nullptr);
+            assign(S->begin(), S->end(), S->cardinality());
+            delete S;
+        }
+    }
+
+    /*
+     * Call f(first, last) with the range of the values: the inline array, or the heap Set
+     */
+    template <typename F>
+    decltype(auto) visit(F f) const {
+        return spilled ? f(spilled->begin(), spilled->end()) : f(values, values + counter);
+    }
+
+    /*
+     * Apply one of +=, *= and -=:
+     * merge(ranges...) if both SmallSets are inline, set_op(Set&, const Set&) otherwise
+     */
+    template <typename Merge, typename SetOp>
+    SmallSet& combine(const SmallSet& S, Merge merge, SetOp set_op);
+
+    /*
+     * Write SmallSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const {
+        if (is_empty()) {
+            os << "Set is empty!";
+        } else {
+            os << "{ ";
+            visit([&](auto first, auto last) {
+                for (; first != last; ++first) os << *first << " ";
+                return 0;
+            });
+            os << "}";
+        }
+    }
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    friend std::ostream& operator<<(std::ostream& os, const SmallSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    friend SmallSet operator+(SmallSet S1, const SmallSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend SmallSet operator*(SmallSet S1, const SmallSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend SmallSet operator-(SmallSet S1, const SmallSet& S2) {
+        return (S1 -= S2);
+    }
+};
+
+/* ******************************************** *
+ * Member Functions -- Implementation           *
+ * ******************************************** */
+
+/*
+ * Add val to the SmallSet, spilling to the heap if the array is full
+ */
+template <std::size_t N>
+bool SmallSet<N>::insert(int val) {
+    if (spilled)
+        return spilled->insert(val).second;
+
+    int* pos = std::lower_bound(values, values + counter, val);
+    if (pos != values + counter && *pos == val)
+        return false;
+    if (counter == N) {
+        spill();
+        return spilled->insert(val).second;
+    }
+    std::copy_backward(pos, values + counter, values + counter + 1);
+    *pos = val;
+    ++counter;
+    return true;
+}
+
+/*
+ * Remove val from the SmallSet
+ */
+template <std::size_t N>
+bool SmallSet<N>::erase(int val) {
+    if (spilled) {
+        const bool erased = (spilled->erase(val) == 1);
+        unspill();
+        return erased;
+    }
+
+    int* pos = std::lower_bound(values, values + counter, val);
+    if (pos == values + counter || *pos != val)
+        return false;
+    std::copy(pos + 1, values + counter, pos);
+    --counter;
+    return true;
+}
+
+/*
+ * Three-way comparison operator: set inclusion, as for class Set
+ */
+template <std::size_t N>
+std::partial_ordering SmallSet<N>::operator<=>(const SmallSet& S) const {
+    if (spilled && S.spilled)
+        return (*spilled <=> *S.spilled);
+
+    const std::size_t n1 = cardinality();
+    const std::size_t n2 = S.cardinality();
+    if (n1 == n2)
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+
+    const bool subset = visit([&](auto first1, auto last1) {
+        return S.visit([&](auto first2, auto last2) {
+            return (n1 < n2) ? std::includes(first2, last2, first1, last1) : std::includes(first1, last1, first2, last2);
+        });
+    });
+    if (!subset)
+        return std::partial_ordering::unordered;
+    return (n1 < n2) ? std::partial_ordering::less : std::partial_ordering::greater;
+}
+
+/*
+ * Apply one of +=, *= and -=
+ * Two inline SmallSets are merged into a buffer on the stack, which is copied back inline if it fits
+ * Otherwise the operation is done by class Set, and the result is moved back inline if it is small enough
+ */
+template <std::size_t N>
+template <typename Merge, typename SetOp>
+SmallSet<N>& SmallSet<N>::combine(const SmallSet& S, Merge merge, SetOp set_op) {
+    if (!spilled && !S.spilled) {
+        int buffer[2 * N];
+        const std::size_t n =
+            static_cast<std::size_t>(merge(values, values + counter, S.values, S.values + S.counter, buffer) - buffer);
+        assign(buffer, buffer + n, n);
+        return *this;
+    }
+
+    spill();
+    if (S.spilled) {
+        set_op(*spilled, *S.spilled);
+    } else {
+        set_op(*spilled, S.to_set());
+    }
+    unspill();
+    return *this;
+}
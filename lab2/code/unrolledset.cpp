@@ -0,0 +1,455 @@
+#include "unrolledset.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+/*****************************************************
+ * Blocks and cursors                                 *
+ ******************************************************/
+
+/*
+ * Block of an unrolled list: up to capacity sorted values, values[0, count)
+ */
+struct UnrolledSet::Block {
+    static constexpr int capacity = 27;  // 2 pointers, the count and 27 ints fill 128 bytes
+
+    explicit Block(Block* nextPtr = nullptr, Block* prevPtr = nullptr) : next{nextPtr}, prev{prevPtr} {
+        ++count_blocks;
+    }
+
+    ~Block() {
+        --count_blocks;
+        assert(count_blocks >= 0);  // number of existing blocks can never be negative
+    }
+
+    Block(const Block& rhs) = delete;
+    Block& operator=(const Block& rhs) = delete;
+
+    Block* next;
+    Block* prev;
+    int count{0};
+    int values[capacity];
+
+    static int count_blocks;  // total number of existing blocks -- to help to detect bugs in the code
+};
+
+int UnrolledSet::Block::count_blocks = 0;
+
+/*
+ * Reads the values of a list in increasing order, block after block
+ */
+class UnrolledSet::Cursor {
+public:
+    explicit Cursor(const UnrolledSet& S) : block{S.head->next}, tail{S.tail} {
+    }
+
+    bool done() const {
+        return (block == tail);
+    }
+
+    int value() const {
+        return block->values[i];
+    }
+
+    void next() {
+        if (++i == block->count) {  // blocks are never empty
+            block = block->next;
+            i = 0;
+        }
+    }
+
+    /*
+     * Move to the first value larger than or equal to val, skipping whole blocks
+     */
+    void seek(int val) {
+        while (block != tail && block->values[block->count - 1] < val) {
+            block = block->next;
+            i = 0;
+        }
+        while (block != tail && block->values[i] < val) {
+            next();
+        }
+    }
+
+private:
+    Block* block;
+    Block* tail;
+    int i{0};
+};
+
+/*****************************************************
+ * Implementation of the member functions             *
+ ******************************************************/
+
+/*
+ * Return number of existing blocks, including dummy blocks
+ */
+int UnrolledSet::get_count_blocks() {
+    return Block::count_blocks;
+}
+
+/*
+ *  Default constructor :create an empty UnrolledSet
+ */
+UnrolledSet::UnrolledSet() : head{new Block()}, tail{new Block(nullptr, head)}, counter{0} {
+    head->next = tail;
+}
+
+/*
+ *  Conversion constructor: convert val into a singleton {val}
+ */
+UnrolledSet::UnrolledSet(int val) : UnrolledSet{} {
+    push_back(val);
+}
+
+/*
+ * Constructor to create an UnrolledSet from a sorted vector of ints
+ */
+UnrolledSet::UnrolledSet(const std::vector<int>& list_of_values) : UnrolledSet{} {
+    for (int val : list_of_values) {
+        push_back(val);
+    }
+}
+
+/*
+ * Constructor to create an UnrolledSet with the same elements as Set S
+ */
+UnrolledSet::UnrolledSet(const Set& S) : UnrolledSet{} {
+    for (int val : S) {
+        push_back(val);
+    }
+}
+
+/*
+ * Copy constructor: create a new UnrolledSet as a copy of S, block by block
+ */
+UnrolledSet::UnrolledSet(const UnrolledSet& S) : UnrolledSet{} {
+    for (Block* p = S.head->next; p != S.tail; p = p->next) {
+        Block* b = insert_block(tail->prev);
+        std::copy(p->values, p->values + p->count, b->values);
+        b->count = p->count;
+    }
+    counter = S.counter;
+}
+
+/*
+ * Move constructor: steal the blocks of S, S becomes an empty UnrolledSet
+ */
+UnrolledSet::UnrolledSet(UnrolledSet&& S) : UnrolledSet{} {
+    std::swap(head, S.head);
+    std::swap(tail, S.tail);
+    std::swap(counter, S.counter);
+}
+
+/*
+ * Destructor: deallocate all blocks
+ */
+UnrolledSet::~UnrolledSet() {
+    make_empty();
+    delete head;
+    delete tail;
+}
+
+/*
+ * Assignment operator, call by value is used
+ */
+UnrolledSet& UnrolledSet::operator=(UnrolledSet S) {
+    std::swap(head, S.head);
+    std::swap(tail, S.tail);
+    std::swap(counter, S.counter);
+    return *this;
+}
+
+/*
+ * Return a Set with the same elements as the UnrolledSet
+ */
+Set UnrolledSet::to_set() const {
+    Set S;
+    for (Cursor c{*this}; !c.done(); c.next()) {
+        S.insert(S.end(), c.value());
+    }
+    return S;
+}
+
+/*
+ * Return a sorted vector with all ints in the UnrolledSet
+ */
+std::vector<int> UnrolledSet::to_vector() const {
+    std::vector<int> list_of_values;
+    list_of_values.reserve(counter);
+    for (Block* p = head->next; p != tail; p = p->next) {
+        list_of_values.insert(list_of_values.end(), p->values, p->values + p->count);
+    }
+    return list_of_values;
+}
+
+/*
+ * Transform the UnrolledSet into an empty set
+ */
+void UnrolledSet::make_empty() {
+    while (head->next != tail) {
+        remove_block(head->next);
+    }
+    counter = 0;
+}
+
+/*
+ * Test whether val belongs to the UnrolledSet
+ */
+bool UnrolledSet::is_member(int val) const {
+    Cursor c{*this};
+    c.seek(val);
+    return (!c.done() && c.value() == val);
+}
+
+/*
+ * Add val to the UnrolledSet
+ * val goes into the first block whose last value is larger than or equal to val (or the last block)
+ * A full block is split into two halves first
+ */
+bool UnrolledSet::insert(int val) {
+    if (is_empty()) {
+        push_back(val);
+        return true;
+    }
+
+    Block* b = head->next;
+    while (b->next != tail && b->values[b->count - 1] < val) {
+        b = b->next;
+    }
+    int* pos = std::lower_bound(b->values, b->values + b->count, val);
+    if (pos != b->values + b->count && *pos == val)
+        return false;
+
+    if (b->count == Block::capacity) {
+        constexpr int half = Block::capacity / 2;
+        Block* c = insert_block(b);
+        std::copy(b->values + half, b->values + Block::capacity, c->values);
+        c->count = Block::capacity - half;
+        b->count = half;
+        if (b->values[half - 1] < val) {
+            b = c;
+        }
+        pos = std::lower_bound(b->values, b->values + b->count, val);
+    }
+
+    std::copy_backward(pos, b->values + b->count, b->values + b->count + 1);
+    *pos = val;
+    ++b->count;
+    ++counter;
+    return true;
+}
+
+/*
+ * Remove val from the UnrolledSet
+ * An empty block is removed, and a block is merged with a neighbour when both fit in half a block
+ */
+bool UnrolledSet::erase(int val) {
+    Block* b = head->next;
+    while (b != tail && b->values[b->count - 1] < val) {
+        b = b->next;
+    }
+    if (b == tail)
+        return false;
+    int* pos = std::lower_bound(b->values, b->values + b->count, val);
+    if (*pos != val)
+        return false;
+
+    std::copy(pos + 1, b->values + b->count, pos);
+    --b->count;
+    --counter;
+
+    if (b->count == 0) {
+        remove_block(b);
+    } else if (Block* a = b->prev; a != head && a->count + b->count <= Block::capacity / 2) {
+        merge_next(a);
+    } else if (b->next != tail && b->count + b->next->count <= Block::capacity / 2) {
+        merge_next(b);
+    }
+    return true;
+}
+
+/*
+ * Test whether *this and S represent the same set
+ */
+bool UnrolledSet::operator==(const UnrolledSet& S) const {
+    if (counter != S.counter)
+        return false;
+    for (Cursor a{*this}, b{S}; !a.done(); a.next(), b.next()) {
+        if (a.value() != b.value())
+            return false;
+    }
+    return true;
+}
+
+/*
+ * Three-way comparison operator: set inclusion, as for class Set
+ */
+std::partial_ordering UnrolledSet::operator<=>(const UnrolledSet& S) const {
+    if (counter == S.counter) {
+        return (*this == S) ? std::partial_ordering::equivalent : std::partial_ordering::unordered;
+    }
+
+    const bool shorter = (counter < S.counter);
+    Cursor c_short{shorter ? *this : S};
+    Cursor c_long{shorter ? S : *this};
+    for (; !c_short.done(); c_short.next()) {
+        c_long.seek(c_short.value());
+        if (c_long.done() || c_long.value() != c_short.value())
+            return std::partial_ordering::unordered;
+    }
+    return shorter ? std::partial_ordering::less : std::partial_ordering::greater;
+}
+
+/*
+ * Modify *this such that it becomes the union of *this with S
+ * Both lists are merged into a new list of full blocks
+ */
+UnrolledSet& UnrolledSet::operator+=(const UnrolledSet& S) {
+    if (S.is_empty())
+        return *this;
+
+    UnrolledSet result;
+    Cursor a{*this};
+    Cursor b{S};
+    while (!a.done() && !b.done()) {
+        if (a.value() < b.value()) {
+            result.push_back(a.value());
+            a.next();
+        } else if (b.value() < a.value()) {
+            result.push_back(b.value());
+            b.next();
+        } else {
+            result.push_back(a.value());
+            a.next();
+            b.next();
+        }
+    }
+    for (; !a.done(); a.next()) {
+        result.push_back(a.value());
+    }
+    for (; !b.done(); b.next()) {
+        result.push_back(b.value());
+    }
+    return (*this = std::move(result));
+}
+
+/*
+ * Modify *this such that it becomes the intersection of *this with S
+ */
+UnrolledSet& UnrolledSet::operator*=(const UnrolledSet& S) {
+    filter(S, [](int val, Cursor& other) {
+        other.seek(val);
+        return (!other.done() && other.value() == val);
+    });
+    return *this;
+}
+
+/*
+ * Modify *this such that it becomes the difference between *this and S
+ */
+UnrolledSet& UnrolledSet::operator-=(const UnrolledSet& S) {
+    filter(S, [](int val, Cursor& other) {
+        other.seek(val);
+        return (other.done() || other.value() != val);
+    });
+    return *this;
+}
+
+/*
+ * Write UnrolledSet *this to stream os, in the same format as a Set
+ */
+void UnrolledSet::write_to_stream(std::ostream& os) const {
+    if (is_empty()) {
+        os << "Set is empty!";
+    } else {
+        os << "{ ";
+        for (Cursor c{*this}; !c.done(); c.next()) {
+            os << c.value() << " ";
+        }
+        os << "}";
+    }
+}
+
+/* ******************************************** *
+ * Private Member Functions -- Implementation   *
+ * ******************************************** */
+
+/*
+ * Append val, larger than all values in the list, filling the last block
+ */
+void UnrolledSet::push_back(int val) {
+    Block* last = tail->prev;
+    if (last == head || last->count == Block::capacity) {
+        last = insert_block(last);
+    }
+    last->values[last->count++] = val;
+    ++counter;
+}
+
+/*
+ * Insert a new empty Block after the Block pointed by p
+ */
+UnrolledSet::Block* UnrolledSet::insert_block(Block* p) {
+    static_assert(sizeof(void*) != 8 || sizeof(Block) == 128, "a block should fill two cache lines");
+    p->next = p->next->prev = new Block(p->next, p);
+    return p->next;
+}
+
+/*
+ * Remove the Block pointed by p
+ */
+void UnrolledSet::remove_block(Block* p) {
+    p->next->prev = p->prev;
+    p->prev->next = p->next;
+    delete p;
+}
+
+/*
+ * Move the values of the Block after p to the end of p, and remove that Block
+ */
+void UnrolledSet::merge_next(Block* p) {
+    Block* q = p->next;
+    std::copy(q->values, q->values + q->count, p->values + p->count);
+    p->count += q->count;
+    remove_block(q);
+}
+
+/*
+ * Keep the values of the list for which keep(value, cursor over S) is true
+ * The kept values are written back from the first block on: the write position never passes
+ * the read position, so no block is allocated. The blocks left over at the end are removed
+ */
+template <typename Keep>
+void UnrolledSet::filter(const UnrolledSet& S, Keep keep) {
+    Cursor other{S};
+    Block* w_block = head->next;
+    int w = 0;
+    size_t kept = 0;
+
+    for (Block* r_block = head->next; r_block != tail; r_block = r_block->next) {
+        for (int r = 0; r < r_block->count; ++r) {
+            const int val = r_block->values[r];
+            if (!keep(val, other))
+                continue;
+            if (w == Block::capacity) {
+                w_block->count = w;
+                w_block = w_block->next;
+                w = 0;
+            }
+            w_block->values[w++] = val;
+            ++kept;
+        }
+    }
+
+    if (kept == 0) {
+        make_empty();
+        return;
+    }
+    w_block->count = w;
+    while (w_block->next != tail) {
+        remove_block(w_block->next);
+    }
+    counter = kept;
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <compare>  // three-way comparison operator <=>
+
+#include "set.h"
+
+/** Class to represent a Set of ints as an unrolled linked list
+ *
+ * UnrolledSet is implemented as a doubly linked list of blocks, with dummy head and tail blocks
+ * Each block stores up to Block::capacity sorted values, so that a block fills two cache lines (128 bytes)
+ * instead of one node per value, as in class Set
+ * All values in a block are smaller than all values in the next block and no block is empty
+ *
+ * insert splits a full block into two halves, erase merges a block with a neighbour
+ * when both fit in one half-full block
+ * +=, *= and -= merge the lists in one pass and produce full blocks
+ *
+ * It has the same interface as class Set, and all operations have a linear time complexity, in the worst case
+ */
+class UnrolledSet {
+public:
+    /*
+     *  Default constructor :create an empty UnrolledSet
+     */
+    UnrolledSet();
+
+    /*
+     *  Conversion constructor: convert val into a singleton {val}
+     */
+    UnrolledSet(int val);
+
+    /*
+     * Constructor to create an UnrolledSet from a sorted vector of ints
+     */
+    explicit UnrolledSet(const std::vector<int>& list_of_values);
+
+    /*
+     * Constructor to create an UnrolledSet with the same elements as Set S
+     */
+    explicit UnrolledSet(const Set& S);
+
+    /*
+     * Copy constructor: create a new UnrolledSet as a copy of S
+     */
+    UnrolledSet(const UnrolledSet& S);
+
+    /*
+     * Move constructor: steal the blocks of S, S becomes an empty UnrolledSet
+     */
+    UnrolledSet(UnrolledSet&& S);
+
+    /*
+     * Destructor: deallocate all blocks
+     */
+    ~UnrolledSet();
+
+    /*
+     * Assignment operator, call by value is used
+     */
+    UnrolledSet& operator=(UnrolledSet S);
+
+    /*
+     * Return a Set with the same elements as the UnrolledSet
+     */
+    Set to_set() const;
+
+    /*
+     * Return a sorted vector with all ints in the UnrolledSet
+     */
+    std::vector<int> to_vector() const;
+
+    /*
+     * Transform the UnrolledSet into an empty set
+     */
+    void make_empty();
+
+    /*
+     * Test whether val belongs to the UnrolledSet
+     * Whole blocks are skipped by comparing val with their last value
+     */
+    bool is_member(int val) const;
+
+    /*
+     * Add val to the UnrolledSet
+     * Return false, if val already belongs to the UnrolledSet
+     */
+    bool insert(int val);
+
+    /*
+     * Remove val from the UnrolledSet
+     * Return false, if val does not belong to the UnrolledSet
+     */
+    bool erase(int val);
+
+    bool is_empty() const {
+        return (counter == 0);
+    }
+
+    size_t cardinality() const {
+        return counter;
+    }
+
+    /*
+     * Test whether *this and S represent the same set
+     */
+    bool operator==(const UnrolledSet& S) const;
+
+    /*
+     * Three-way comparison operator: set inclusion, as for class Set
+     */
+    std::partial_ordering operator<=>(const UnrolledSet& S) const;
+
+    /*
+     * Modify *this such that it becomes the union of *this with S
+     */
+    UnrolledSet& operator+=(const UnrolledSet& S);
+
+    /*
+     * Modify *this such that it becomes the intersection of *this with S
+     * The remaining values are compacted into the first blocks, no block is allocated
+     */
+    UnrolledSet& operator*=(const UnrolledSet& S);
+
+    /*
+     * Modify *this such that it becomes the difference between *this and S
+     * The remaining values are compacted into the first blocks, no block is allocated
+     */
+    UnrolledSet& operator-=(const UnrolledSet& S);
+
+    /*
+     * Return number of existing blocks, including dummy blocks
+     * Used solely for debug purposes
+     */
+    static int get_count_blocks();
+
+private:
+    struct Block;   // defined in unrolledset.cpp
+    class Cursor;   // reads the values of a list, block after block
+
+    Block* head;     // pointer to the dummy header Block
+    Block* tail;     // pointer to the dummy tail Block
+    size_t counter;  // number of values in the UnrolledSet
+
+    /*
+     * Append val, larger than all values in the list, filling the last block
+     */
+    void push_back(int val);
+
+    /*
+     * Insert a new empty Block after the Block pointed by p
+     */
+    Block* insert_block(Block* p);
+
+    /*
+     * Remove the Block pointed by p
+     */
+    void remove_block(Block* p);
+
+    /*
+     * Move the values of the Block after p to the end of p, and remove that Block
+     */
+    void merge_next(Block* p);
+
+    /*
+     * Keep the values of the list for which keep(value, cursor over S) is true, compacting the blocks
+     * Used by *= and -=
+     */
+    template <typename Keep>
+    void filter(const UnrolledSet& S, Keep keep);
+
+    /*
+     * Write UnrolledSet *this to stream os, in the same format as a Set
+     */
+    void write_to_stream(std::ostream& os) const;
+
+    /* ******************************************* *
+     * Overloaded operators: non-member functions  *
+     * ******************************************* */
+
+    friend std::ostream& operator<<(std::ostream& os, const UnrolledSet& S) {
+        S.write_to_stream(os);
+        return os;
+    }
+
+    friend UnrolledSet operator+(UnrolledSet S1, const UnrolledSet& S2) {
+        return (S1 += S2);
+    }
+
+    friend UnrolledSet operator*(UnrolledSet S1, const UnrolledSet& S2) {
+        return (S1 *= S2);
+    }
+
+    friend UnrolledSet operator-(UnrolledSet S1, const UnrolledSet& S2) {
+        return (S1 -= S2);
+    }
+};